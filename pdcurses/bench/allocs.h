@@ -0,0 +1,23 @@
+/* PDCurses */
+
+/* Force-included (with -include) when the library is built for the
+   microbenchmarks, so that its allocations are counted. The wrappers
+   are in micro.c. <stdlib.h> is included first so that its
+   declarations aren't affected. */
+
+#ifndef __PDC_ALLOCS_H__
+#define __PDC_ALLOCS_H__
+
+#include <stdlib.h>
+
+extern long bench_allocs;
+
+void *bench_malloc(size_t);
+void *bench_calloc(size_t, size_t);
+void *bench_realloc(void *, size_t);
+
+#define malloc(size) bench_malloc(size)
+#define calloc(nmemb, size) bench_calloc(nmemb, size)
+#define realloc(ptr, size) bench_realloc(ptr, size)
+
+#endif
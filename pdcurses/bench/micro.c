@@ -0,0 +1,672 @@
+/* PDCurses */
+
+/* micro - microbenchmarks for the core curses primitives
+
+   usage: micro [-t seconds] [name...]
+
+   Each benchmark is run at a range of screen sizes, from 80x25 up to
+   500x200, against a null platform layer (pdcnull.c), so that only the
+   platform-independent code is measured. It's repeated until it has
+   run for at least the given time (0.2 seconds by default), and the
+   mean time per operation, and the number of allocations (malloc(),
+   calloc() and realloc() calls made by the library) per operation, are
+   reported. If names are given, only the benchmarks whose names start
+   with one of them are run. */
+
+#include <curses.h>
+#include <panel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAXPANELS 64
+
+long bench_allocs = 0;
+
+static const struct
+{
+    int cols, lines;
+} sizes[] =
+{
+    {80, 25}, {132, 43}, {200, 60}, {300, 100}, {500, 200}
+};
+
+static WINDOW *win, *win2;
+static PANEL *panels[MAXPANELS];
+static int npanels;
+static char line[512];
+
+void *bench_malloc(size_t size)
+{
+    bench_allocs++;
+    return malloc(size);
+}
+
+void *bench_calloc(size_t nmemb, size_t size)
+{
+    bench_allocs++;
+    return calloc(nmemb, size);
+}
+
+void *bench_realloc(void *ptr, size_t size)
+{
+    bench_allocs++;
+    return realloc(ptr, size);
+}
+
+static double now(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+#else
+    return clock() * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* the benchmarks -- each performs n operations on win */
+
+static void b_waddch(long n)
+{
+    long i, cells = (long)LINES * COLS;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!(i % cells))
+            wmove(win, 0, 0);
+
+        waddch(win, 'a' + i % 26);
+    }
+}
+
+static void b_waddnstr(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        mvwaddnstr(win, i % LINES, 0, line, COLS);
+}
+
+static void b_winsnstr(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        mvwinsnstr(win, i % LINES, COLS / 4, line, 64);
+}
+
+static void b_mvwprintw(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        mvwprintw(win, i % LINES, 0, "%8ld: %s %d", i, "printw", COLS);
+}
+
+/* output longer than printw()'s stack buffer */
+
+static void b_mvwprintw_long(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        mvwprintw(win, 0, 0, "%ld %s%s", i, line, line);
+}
+
+static void b_wclrtobot(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        wmove(win, LINES / 2, COLS / 2);
+        wclrtobot(win);
+    }
+}
+
+static void b_wscrl(long n)
+{
+    long i;
+
+    scrollok(win, TRUE);
+
+    for (i = 0; i < n; i++)
+        wscrl(win, 1);
+
+    scrollok(win, FALSE);
+}
+
+static void b_wbkgd(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        wbkgd(win, (i & 1) ? COLOR_PAIR(1) | '.' : COLOR_PAIR(2) | ' ');
+}
+
+static void b_overlay(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        overlay(win2, win);
+}
+
+static void b_copywin(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        copywin(win2, win, 0, 0, 0, 0, LINES - 1, COLS - 1, FALSE);
+}
+
+/* wresize() by a line and a column, back and forth, as when dragging
+   the edge of the screen */
+
+static void b_wresize(long n)
+{
+    WINDOW *w = newwin(LINES, COLS, 0, 0);
+    long i;
+
+    for (i = 0; i < n; i++)
+        wresize(w, LINES - 1 + (i & 1), COLS - 1 + (i & 1));
+
+    delwin(w);
+}
+
+/* dupwin() and PDC_snapshot(), each followed by a write to one line
+   and the release of the copy */
+
+static void b_dupwin(long n)
+{
+    WINDOW *dup;
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        dup = dupwin(win);
+        mvwaddch(dup, i % LINES, 0, 'x');
+        delwin(dup);
+    }
+}
+
+static void b_snapshot(long n)
+{
+    PDC_SNAPSHOT *snap;
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        snap = PDC_snapshot(win);
+        mvwaddch(win, i % LINES, 0, 'x');
+        PDC_restore_snapshot(win, snap);
+        PDC_free_snapshot(snap);
+    }
+}
+
+/* a popup: a bordered window with a line of text, made, shown and
+   deleted, with delwin() and with an arena scope */
+
+static void b_popup(long n)
+{
+    WINDOW *pop;
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        pop = newwin(LINES / 2, COLS / 2, LINES / 4, COLS / 4);
+        box(pop, 0, 0);
+        mvwaddstr(pop, 1, 2, "popup");
+        wnoutrefresh(pop);
+        delwin(pop);
+    }
+}
+
+static void b_popup_arena(long n)
+{
+    WINDOW *pop;
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        PDC_arena_begin();
+
+        pop = newwin(LINES / 2, COLS / 2, LINES / 4, COLS / 4);
+        box(pop, 0, 0);
+        mvwaddstr(pop, 1, 2, "popup");
+        wnoutrefresh(pop);
+
+        PDC_arena_end();
+    }
+}
+
+/* drawing a small widget into an immedok() window, a character at a
+   time, and the same in a batch */
+
+static void _widget(WINDOW *w)
+{
+    const char *label = "OK  Cancel  Help";
+    int y;
+
+    box(w, 0, 0);
+
+    for (y = 1; y < 4; y++)
+    {
+        const char *p;
+
+        wmove(w, y, 2);
+        for (p = label; *p; p++)
+            waddch(w, (unsigned char)*p);
+    }
+}
+
+static void b_immedok(long n)
+{
+    WINDOW *w = newwin(5, 20, 1, 1);
+    long i;
+
+    immedok(w, TRUE);
+
+    for (i = 0; i < n; i++)
+        _widget(w);
+
+    delwin(w);
+}
+
+static void b_immedok_batch(long n)
+{
+    WINDOW *w = newwin(5, 20, 1, 1);
+    long i;
+
+    immedok(w, TRUE);
+
+    for (i = 0; i < n; i++)
+    {
+        PDC_begin_batch();
+        _widget(w);
+        PDC_end_batch();
+    }
+
+    delwin(w);
+}
+
+/* wnoutrefresh() with different amounts of damage: every cell, one
+   line, one cell, and one cell on every eighth line */
+
+static void b_wnoutrefresh_full(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        touchwin(win);
+        wnoutrefresh(win);
+    }
+}
+
+static void b_wnoutrefresh_line(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        touchline(win, i % LINES, 1);
+        wnoutrefresh(win);
+    }
+}
+
+static void b_wnoutrefresh_cell(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        mvwaddch(win, i % LINES, i % COLS, 'a' + i % 26);
+        wnoutrefresh(win);
+    }
+}
+
+static void b_wnoutrefresh_sparse(long n)
+{
+    long i;
+    int y;
+
+    for (i = 0; i < n; i++)
+    {
+        for (y = i % 8; y < LINES; y += 8)
+            mvwaddch(win, y, (y * 7 + i) % COLS, 'a' + i % 26);
+
+        wnoutrefresh(win);
+    }
+}
+
+/* pnoutrefresh() of a screen-sized view of a pad four screens long,
+   scrolling down it a line at a time, and standing still while one
+   cell changes */
+
+static void b_pnoutrefresh_scroll(long n)
+{
+    WINDOW *pad = newpad(LINES * 4, COLS);
+    long i;
+    int y;
+
+    for (y = 0; y < LINES * 4; y++)
+        mvwaddnstr(pad, y, y % 8, line, COLS / 2);
+
+    for (i = 0; i < n; i++)
+        pnoutrefresh(pad, i % (LINES * 3), 0, 0, 0, LINES - 1, COLS - 1);
+
+    delwin(pad);
+}
+
+static void b_pnoutrefresh_still(long n)
+{
+    WINDOW *pad = newpad(LINES * 4, COLS);
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        mvwaddch(pad, LINES + i % LINES, i % COLS, 'a' + i % 26);
+        pnoutrefresh(pad, LINES, 0, 0, 0, LINES - 1, COLS - 1);
+    }
+
+    delwin(pad);
+}
+
+/* a PDC_newwin_provider() window the size of the screen, scrolling
+   down a line at a time; the provider formats each line as asked */
+
+static const chtype *provide(void *data, int row, chtype *buf, int ncols)
+{
+    int x;
+
+    for (x = 0; x < ncols; x++)
+        buf[x] = 'a' + (row + x) % 26;
+
+    return buf;
+}
+
+static void b_provider_scroll(long n)
+{
+    WINDOW *list = PDC_newwin_provider(LINES, COLS, 0, 0, provide, NULL);
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        PDC_provider_scroll(list, i);
+        wnoutrefresh(list);
+    }
+
+    delwin(list);
+}
+
+/* a typical frame: erase the window, then draw the same border and
+   text again, eagerly and with PDC_lazy_erase() */
+
+static void b_redraw(long n)
+{
+    long i;
+    int y;
+
+    for (i = 0; i < n; i++)
+    {
+        werase(win);
+        box(win, 0, 0);
+
+        for (y = 1; y < LINES - 1; y += 2)
+            mvwaddnstr(win, y, 2, line, COLS / 2);
+
+        wnoutrefresh(win);
+    }
+}
+
+static void b_redraw_lazy(long n)
+{
+    PDC_lazy_erase(win, TRUE);
+    b_redraw(n);
+    PDC_lazy_erase(win, FALSE);
+}
+
+/* doupdate() redrawing the whole screen, and with nothing to do */
+
+static void b_doupdate_full(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        clearok(curscr, TRUE);
+        doupdate();
+    }
+}
+
+static void b_doupdate_idle(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+        doupdate();
+}
+
+/* a palette fade: changing a color used on every eighth line, and
+   letting napms() show it */
+
+static void b_init_color(long n)
+{
+    long i;
+    int y;
+
+    for (y = 0; y < LINES; y += 8)
+        mvwchgat(win, y, 0, -1, A_NORMAL, 2, NULL);
+
+    touchwin(win);
+    wnoutrefresh(win);
+    doupdate();
+
+    for (i = 0; i < n; i++)
+    {
+        init_color(COLOR_YELLOW, (i & 1) ? 1000 : 500, 1000, 0);
+        napms(0);
+    }
+
+    for (y = 0; y < LINES; y += 8)
+        mvwchgat(win, y, 0, -1, A_NORMAL, 0, NULL);
+}
+
+/* update_panels() after raising one of N overlapping panels */
+
+static void b_update_panels(long n)
+{
+    long i;
+
+    for (i = 0; i < n; i++)
+    {
+        top_panel(panels[i % npanels]);
+        update_panels();
+    }
+}
+
+/* the same, with the panels' windows marked static */
+
+static void b_update_panels_static(long n)
+{
+    int i;
+
+    for (i = 0; i < npanels; i++)
+        wsetstatic(panel_window(panels[i]), TRUE);
+
+    b_update_panels(n);
+}
+
+static void make_panels(int count)
+{
+    int i, h = LINES / 2, w = COLS / 2;
+
+    for (i = 0; i < count; i++)
+    {
+        WINDOW *pwin = newwin(h, w, (i * 3) % (LINES - h),
+                              (i * 7) % (COLS - w));
+
+        wbkgd(pwin, COLOR_PAIR(1 + i % 2) | ' ');
+        box(pwin, 0, 0);
+        mvwprintw(pwin, 1, 1, "panel %d", i);
+
+        panels[i] = new_panel(pwin);
+    }
+
+    npanels = count;
+}
+
+static void free_panels(void)
+{
+    while (npanels)
+    {
+        WINDOW *pwin = panel_window(panels[--npanels]);
+
+        del_panel(panels[npanels]);
+        delwin(pwin);
+    }
+}
+
+static const struct
+{
+    const char *name;
+    void (*func)(long);
+    int panels;
+} benches[] =
+{
+    {"waddch", b_waddch, 0},
+    {"waddnstr", b_waddnstr, 0},
+    {"winsnstr", b_winsnstr, 0},
+    {"mvwprintw", b_mvwprintw, 0},
+    {"mvwprintw/long", b_mvwprintw_long, 0},
+    {"wclrtobot", b_wclrtobot, 0},
+    {"wscrl", b_wscrl, 0},
+    {"wbkgd", b_wbkgd, 0},
+    {"overlay", b_overlay, 0},
+    {"copywin", b_copywin, 0},
+    {"wresize", b_wresize, 0},
+    {"dupwin", b_dupwin, 0},
+    {"snapshot", b_snapshot, 0},
+    {"popup", b_popup, 0},
+    {"popup/arena", b_popup_arena, 0},
+    {"immedok", b_immedok, 0},
+    {"immedok/batch", b_immedok_batch, 0},
+    {"wnoutrefresh/full", b_wnoutrefresh_full, 0},
+    {"wnoutrefresh/line", b_wnoutrefresh_line, 0},
+    {"wnoutrefresh/cell", b_wnoutrefresh_cell, 0},
+    {"wnoutrefresh/sparse", b_wnoutrefresh_sparse, 0},
+    {"pnoutrefresh/scroll", b_pnoutrefresh_scroll, 0},
+    {"pnoutrefresh/still", b_pnoutrefresh_still, 0},
+    {"provider/scroll", b_provider_scroll, 0},
+    {"redraw/eager", b_redraw, 0},
+    {"redraw/lazy", b_redraw_lazy, 0},
+    {"doupdate/full", b_doupdate_full, 0},
+    {"doupdate/idle", b_doupdate_idle, 0},
+    {"init_color", b_init_color, 0},
+    {"update_panels/1", b_update_panels, 1},
+    {"update_panels/8", b_update_panels, 8},
+    {"update_panels/64", b_update_panels, 64},
+    {"static_panels/8", b_update_panels_static, 8},
+    {"static_panels/64", b_update_panels_static, 64},
+    {NULL, NULL, 0}
+};
+
+static void fill(WINDOW *w, int spaces)
+{
+    int y, x;
+
+    for (y = 0; y < LINES; y++)
+        for (x = 0; x < COLS; x++)
+            mvwaddch(w, y, x, (spaces && (x + y) % 3) ? ' ' :
+                              'A' + (x + y) % 26);
+}
+
+static void run(int b, double mintime)
+{
+    double start, elapsed;
+    long n = 1, allocs;
+
+    if (benches[b].panels)
+        make_panels(benches[b].panels);
+
+    /* double the count until it takes long enough to measure */
+
+    for (;;)
+    {
+        allocs = bench_allocs;
+        start = now();
+
+        benches[b].func(n);
+
+        elapsed = now() - start;
+        allocs = bench_allocs - allocs;
+
+        if (elapsed >= mintime * 1e9 || n >= 1L << 30)
+            break;
+
+        n *= 2;
+    }
+
+    printf("%-22s %4dx%-4d %11ld %12.1f %10.3f\n", benches[b].name,
+           COLS, LINES, n, elapsed / n, (double)allocs / n);
+
+    free_panels();
+}
+
+int main(int argc, char **argv)
+{
+    double mintime = 0.2;
+    int i, j, s;
+
+    if (argc > 2 && !strcmp(argv[1], "-t"))
+    {
+        mintime = atof(argv[2]);
+        argc -= 2;
+        argv += 2;
+    }
+
+    memset(line, 'x', sizeof(line) - 1);
+
+    initscr();
+    start_color();
+    init_pair(1, COLOR_WHITE, COLOR_BLUE);
+    init_pair(2, COLOR_YELLOW, COLOR_BLACK);
+
+    printf("%-22s %-9s %11s %12s %10s\n", "benchmark", "size", "ops",
+           "ns/op", "allocs/op");
+
+    for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++)
+    {
+        resize_term(sizes[s].lines, sizes[s].cols);
+
+        win = newwin(LINES, COLS, 0, 0);
+        win2 = newwin(LINES, COLS, 0, 0);
+
+        fill(win, 0);
+        fill(win2, 1);
+
+        for (i = 0; benches[i].name; i++)
+        {
+            bool wanted = (argc < 2);
+
+            for (j = 1; j < argc; j++)
+                if (!strncmp(benches[i].name, argv[j], strlen(argv[j])))
+                    wanted = TRUE;
+
+            if (wanted)
+                run(i, mintime);
+        }
+
+        delwin(win);
+        delwin(win2);
+    }
+
+    endwin();
+
+    return 0;
+}
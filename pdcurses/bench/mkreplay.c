@@ -0,0 +1,88 @@
+/* PDCurses */
+
+/* mkreplay - write an input log for PDC_replay_input()
+
+   usage: mkreplay file event...
+
+   Each event is given as delay:key, where delay is the time in
+   milliseconds (as counted by napms()) since the previous event, and
+   key is either a single character, one of the names below, or a
+   number. Numbers of KEY_MIN and above are sent as function keys. */
+
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct
+{
+    const char *name;
+    int key;
+} keynames[] =
+{
+    {"esc", 27}, {"enter", '\n'}, {"space", ' '}, {"tab", '\t'},
+    {"up", KEY_UP}, {"down", KEY_DOWN}, {"left", KEY_LEFT},
+    {"right", KEY_RIGHT}, {NULL, 0}
+};
+
+static void put_num(FILE *fp, unsigned long num)
+{
+    while (num > 0x7f)
+    {
+        putc((int)(num & 0x7f) | 0x80, fp);
+        num >>= 7;
+    }
+
+    putc((int)num, fp);
+}
+
+int main(int argc, char **argv)
+{
+    static const char sig[8] = {'P', 'D', 'C', 'r', 'e', 'c', 0, 1};
+    FILE *fp;
+    int i, j;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s file [delay:key]...\n", argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[1], "wb");
+    if (!fp)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fwrite(sig, sizeof(sig), 1, fp);
+
+    for (i = 2; i < argc; i++)
+    {
+        char *name;
+        unsigned long delay = strtoul(argv[i], &name, 10);
+        int key = -1;
+
+        if (*name++ != ':' || !*name)
+        {
+            fprintf(stderr, "%s: bad event '%s'\n", argv[0], argv[i]);
+            return 1;
+        }
+
+        for (j = 0; keynames[j].name; j++)
+            if (!strcmp(name, keynames[j].name))
+                key = keynames[j].key;
+
+        if (key == -1)
+            key = name[1] ? atoi(name) : (unsigned char)*name;
+
+        putc(key >= KEY_MIN, fp);   /* flags: key code */
+        put_num(fp, delay);
+        put_num(fp, (unsigned long)key);
+        put_num(fp, 0);             /* modifiers */
+    }
+
+    fclose(fp);
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+/* PDCurses */
+
+/* A null platform layer, for the microbenchmarks. It has a screen of
+   any size (set by resize_term()), full color, and no input, and its
+   output functions do nothing, so that only the time spent in the
+   platform-independent code is measured. */
+
+#include <curspriv.h>
+
+#include <stdlib.h>
+
+static int null_rows = 25, null_cols = 80;
+
+static short null_red[PDC_MAXCOL], null_green[PDC_MAXCOL],
+             null_blue[PDC_MAXCOL];
+
+/* pdcclip */
+
+int PDC_getclipboard(char **contents, long *length)
+{
+    return PDC_CLIP_EMPTY;
+}
+
+int PDC_setclipboard(const char *contents, long length)
+{
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_freeclipboard(char *contents)
+{
+    free(contents);
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_clearclipboard(void)
+{
+    return PDC_CLIP_SUCCESS;
+}
+
+/* pdcdisp */
+
+void PDC_gotoyx(int row, int col)
+{
+}
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+}
+
+void PDC_doupdate(void)
+{
+}
+
+/* pdcgetsc */
+
+int PDC_get_columns(void)
+{
+    return null_cols;
+}
+
+int PDC_get_cursor_mode(void)
+{
+    return 0;
+}
+
+int PDC_get_rows(void)
+{
+    return null_rows;
+}
+
+/* pdckbd */
+
+bool PDC_check_key(void)
+{
+    return FALSE;
+}
+
+int PDC_get_key(void)
+{
+    return -1;
+}
+
+void PDC_flushinp(void)
+{
+}
+
+bool PDC_has_mouse(void)
+{
+    return FALSE;
+}
+
+int PDC_mouse_set(void)
+{
+    return OK;
+}
+
+int PDC_modifiers_set(void)
+{
+    return OK;
+}
+
+void PDC_set_keyboard_binary(bool on)
+{
+}
+
+/* pdcscrn */
+
+void PDC_scr_close(void)
+{
+}
+
+void PDC_scr_free(void)
+{
+}
+
+int PDC_scr_open(void)
+{
+    SP->mono = FALSE;
+    SP->orig_attr = FALSE;
+    SP->termattrs = A_COLOR | A_UNDERLINE | A_REVERSE;
+
+    return OK;
+}
+
+int PDC_resize_screen(int nlines, int ncols)
+{
+    if (nlines && ncols)
+    {
+        null_rows = nlines;
+        null_cols = ncols;
+    }
+
+    return OK;
+}
+
+void PDC_reset_prog_mode(void)
+{
+}
+
+void PDC_reset_shell_mode(void)
+{
+}
+
+void PDC_restore_screen_mode(int i)
+{
+}
+
+void PDC_save_screen_mode(int i)
+{
+}
+
+bool PDC_can_change_color(void)
+{
+    return TRUE;
+}
+
+int PDC_color_content(short color, short *red, short *green, short *blue)
+{
+    *red = null_red[color];
+    *green = null_green[color];
+    *blue = null_blue[color];
+
+    return OK;
+}
+
+int PDC_init_color(short color, short red, short green, short blue)
+{
+    null_red[color] = red;
+    null_green[color] = green;
+    null_blue[color] = blue;
+
+    return OK;
+}
+
+/* pdcsetsc */
+
+int PDC_curs_set(int visibility)
+{
+    int ret_vis = SP->visibility;
+
+    SP->visibility = visibility;
+
+    return ret_vis;
+}
+
+void PDC_set_title(const char *title)
+{
+}
+
+int PDC_set_blink(bool blinkon)
+{
+    if (SP && SP->color_started)
+        COLORS = PDC_MAXCOL;
+
+    return OK;
+}
+
+int PDC_set_bold(bool boldon)
+{
+    return OK;
+}
+
+/* pdcutil */
+
+void PDC_beep(void)
+{
+}
+
+void PDC_napms(int ms)
+{
+}
+
+const char *PDC_sysname(void)
+{
+    return "null";
+}
@@ -0,0 +1,280 @@
+/* PDCurses */
+
+/* pdctrace - decode a dump made by PDC_trace_dump()
+
+   usage: pdctrace file
+
+   Prints one line per record: the time in seconds since tracing
+   started, the category, the source file, and the message, formatted
+   as PDC_debug() would have. String arguments appear truncated to the
+   length that was recorded. */
+
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAXARGS 4
+
+typedef struct
+{
+    unsigned long category;
+    char *file;
+    char *fmt;
+} SITE;
+
+static FILE *fp;
+
+static unsigned long get_num(void)
+{
+    unsigned long num = 0;
+    int c, shift = 0;
+
+    do
+    {
+        c = getc(fp);
+        if (c == EOF)
+        {
+            fprintf(stderr, "pdctrace: unexpected end of file\n");
+            exit(1);
+        }
+
+        num |= (unsigned long)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    return num;
+}
+
+static char *get_str(void)
+{
+    unsigned long len = get_num();
+    char *str = malloc(len + 1);
+
+    if (!str || (len && fread(str, len, 1, fp) != 1))
+    {
+        fprintf(stderr, "pdctrace: bad string\n");
+        exit(1);
+    }
+
+    str[len] = '\0';
+
+    return str;
+}
+
+static const char *category_name(unsigned long category)
+{
+    static const char *names[] = {"output", "refresh", "input", "window",
+                                  "color", "platform", "misc"};
+    int i;
+
+    for (i = 0; i < 7; i++)
+        if (category == 1UL << i)
+            return names[i];
+
+    return "?";
+}
+
+static const char *base_name(const char *file)
+{
+    const char *base = file;
+
+    for (; *file; file++)
+        if (*file == '/' || *file == '\\' || *file == ':')
+            base = file + 1;
+
+    return base;
+}
+
+/* print a message, substituting the arguments into the format one
+   conversion at a time; numbers were recorded as unsigned, so the
+   signed conversions are cast back */
+
+static void print_message(const char *fmt, unsigned long *nums,
+                          char **strs, int nargs)
+{
+    char spec[32];
+    int arg = 0;
+
+    while (*fmt)
+    {
+        size_t len = 0;
+        char conv;
+
+        if (*fmt != '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+
+        if (fmt[1] == '%')
+        {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        /* copy the flags and width, dropping any length modifier */
+
+        spec[len++] = *fmt++;
+
+        while (*fmt && strchr("-+ #0123456789.lh", *fmt))
+        {
+            if (*fmt != 'l' && *fmt != 'h' && len < sizeof(spec) - 3)
+                spec[len++] = *fmt;
+            fmt++;
+        }
+
+        conv = *fmt;
+        if (!conv)
+            break;
+
+        fmt++;
+
+        if (arg >= nargs)
+        {
+            putchar('?');
+            continue;
+        }
+
+        if (conv == 's' || conv == 'c')
+            spec[len++] = conv;
+        else if (conv != 'p')
+        {
+            spec[len++] = 'l';
+            spec[len++] = conv;
+        }
+
+        spec[len] = '\0';
+
+        switch (conv)
+        {
+        case 's':
+            printf(spec, strs[arg]);
+            break;
+        case 'c':
+            printf(spec, (int)nums[arg]);
+            break;
+        case 'p':
+            printf("0x%lx", nums[arg]);
+            break;
+        case 'd':
+        case 'i':
+            printf(spec, (long)(int)nums[arg]);
+            break;
+        default:
+            printf(spec, nums[arg]);
+        }
+
+        arg++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const char sig[8] = {'P', 'D', 'C', 't', 'r', 'c', 0, 1};
+    char buf[8];
+    SITE *sites;
+    unsigned long nsites, nrecs, i;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s file\n", argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[1], "rb");
+    if (!fp)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fread(buf, sizeof(buf), 1, fp) != 1 || memcmp(buf, sig, 8))
+    {
+        fprintf(stderr, "%s: not a PDCurses trace dump\n", argv[1]);
+        return 1;
+    }
+
+    nsites = get_num();
+    sites = malloc((nsites + 1) * sizeof(SITE));
+    if (!sites)
+        return 1;
+
+    for (i = 0; i < nsites; i++)
+    {
+        sites[i].category = get_num();
+        sites[i].file = get_str();
+        sites[i].fmt = get_str();
+    }
+
+    nrecs = get_num();
+
+    for (i = 0; i < nrecs; i++)
+    {
+        unsigned long when = get_num();
+        unsigned long site = get_num();
+        unsigned long nargs = get_num();
+        unsigned long nums[MAXARGS];
+        char *strs[MAXARGS];
+        const char *fmt;
+        size_t j;
+
+        if (site >= nsites || nargs > MAXARGS)
+        {
+            fprintf(stderr, "%s: bad record\n", argv[1]);
+            return 1;
+        }
+
+        /* the arguments that were strings are marked by %s in the
+           format, in order */
+
+        fmt = sites[site].fmt;
+
+        for (j = 0; j < nargs; j++)
+        {
+            bool isstr = FALSE;
+
+            while (fmt && (fmt = strchr(fmt, '%')) != NULL)
+            {
+                fmt++;
+                if (*fmt == '%')
+                {
+                    fmt++;
+                    continue;
+                }
+
+                fmt += strspn(fmt, "-+ #0123456789.lh");
+                isstr = (*fmt == 's');
+                break;
+            }
+
+            if (isstr)
+                strs[j] = get_str();
+            else
+            {
+                strs[j] = NULL;
+                nums[j] = get_num();
+            }
+        }
+
+        printf("%lu.%06lu %-8s %-10s ", when / 1000000, when % 1000000,
+               category_name(sites[site].category),
+               base_name(sites[site].file));
+
+        print_message(sites[site].fmt, nums, strs, (int)nargs);
+
+        for (j = 0; j < nargs; j++)
+            free(strs[j]);
+
+        /* most formats end with a newline, but not all */
+
+        fmt = sites[site].fmt;
+        if (!*fmt || fmt[strlen(fmt) - 1] != '\n')
+            putchar('\n');
+    }
+
+    fclose(fp);
+
+    return 0;
+}
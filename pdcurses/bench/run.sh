@@ -0,0 +1,48 @@
+#!/bin/sh
+# Run the frame-time benchmarks: run.sh demo...
+#
+# Each demo is run as ./bench_<demo>, with its input replayed at full
+# speed from a scripted log (see mkreplay.c), and the results are
+# written to standard output as a JSON array, one entry per demo.
+
+SPACES="1000:space 1000:space 1000:space 1000:space 1000:space 1000:space"
+MOVES="200:right 200:right 200:down 200:down 200:left 200:left 200:up 200:up"
+
+script()
+{
+    case $1 in
+    firework)   echo "20000:space" ;;
+    ozdemo)     echo "30000:esc 6000:esc 6000:esc 6000:esc" ;;
+    rain|worm)  echo "20000:q" ;;
+    sdltest)    echo "$MOVES $MOVES $MOVES $MOVES 200:q 1000:space" ;;
+    testcurs)   echo "500:enter $SPACES 100:down 100:down 100:down" \
+                     "100:enter $SPACES 100:down 100:down 100:down" \
+                     "100:enter $SPACES 100:down 100:enter $SPACES" \
+                     "100:down 100:enter $SPACES 500:q" ;;
+    *)          echo "" ;;
+    esac
+}
+
+SDL_VIDEODRIVER=${SDL_VIDEODRIVER:-dummy}
+SDL_RENDER_DRIVER=${SDL_RENDER_DRIVER:-software}
+export SDL_VIDEODRIVER SDL_RENDER_DRIVER
+
+out=bench.tmp
+rm -f $out
+
+for demo in "$@"
+do
+    ./mkreplay $demo.rec `script $demo` || exit 1
+
+    PDC_BENCH=$out PDC_BENCH_NAME=$demo PDC_REPLAY=$demo.rec \
+        timeout 300 ./bench_$demo >/dev/null 2>&1 ||
+        echo "run.sh: $demo failed" >&2
+
+    rm -f $demo.rec
+done
+
+echo "["
+sed '$!s/$/,/' $out 2>/dev/null
+echo "]"
+
+rm -f $out
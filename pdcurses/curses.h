@@ -129,6 +129,50 @@ enum
     PDC_VFLAG_RGB   = 16  /* -DPDC_RGB */
 };
 
+/*----------------------------------------------------------------------
+ *
+ *  Statistics
+ *
+ */
+
+/* Counters at the main choke points of output and input, for use with
+   PDC_get_stats(). Those marked "platform" are kept by the SDL ports
+   only; the rest, by all. */
+
+typedef struct PDC_STATS
+{
+    unsigned long updates;        /* doupdate() calls */
+    unsigned long cells_copied;   /* cells copied to curscr by
+                                     wnoutrefresh() and pnoutrefresh() */
+    unsigned long cells_compared; /* cells compared with the screen by
+                                     doupdate() */
+    unsigned long runs;           /* runs of changed cells passed by
+                                     doupdate() to the platform */
+    unsigned long cells_drawn;    /* cells in those runs */
+    unsigned long packets;        /* same-attribute packets (platform) */
+    unsigned long blits;          /* glyphs and backgrounds blitted
+                                     (platform) */
+    unsigned long rects;          /* rectangles presented (platform) */
+    unsigned long renders;        /* glyphs rendered by SDL_ttf
+                                     (platform) */
+    unsigned long events;         /* input events polled (platform) */
+    unsigned long allocs;         /* memory allocations by the library */
+} PDC_STATS;
+
+/* Categories of PDC_LOG() calls, for PDC_trace_filter() */
+
+enum
+{
+    PDC_TRACE_OUTPUT   = 0x01,  /* writing to windows */
+    PDC_TRACE_REFRESH  = 0x02,  /* refreshes, pads and panels */
+    PDC_TRACE_INPUT    = 0x04,  /* keyboard and mouse */
+    PDC_TRACE_WINDOW   = 0x08,  /* windows and the screen */
+    PDC_TRACE_COLOR    = 0x10,  /* colors and attributes */
+    PDC_TRACE_PLATFORM = 0x20,  /* the platform layer */
+    PDC_TRACE_MISC     = 0x40,  /* everything else */
+    PDC_TRACE_ALL      = 0x7f
+};
+
 /*----------------------------------------------------------------------
  *
  *  Mouse Interface
@@ -313,8 +357,21 @@ typedef struct _win       /* definition of a window */
         int _pad_bottom;
         int _pad_right;
     } _pad;               /* Pad-properties structure */
+    struct _pdc_lazy *_lazy; /* lazy erase state, if enabled */
+    struct _pdc_cow *_cow;   /* lines shared copy-on-write, if any */
+    struct _pdc_provider *_provider; /* line provider, if any */
 } WINDOW;
 
+/* Saved window contents, from PDC_snapshot() */
+
+typedef struct _pdc_snapshot PDC_SNAPSHOT;
+
+/* Line provider callback, for PDC_newpad_provider() and
+   PDC_newwin_provider() */
+
+typedef const chtype *(*PDC_LINEPROC)(void *data, int line, chtype *buf,
+                                      int ncols);
+
 /* Color pair structure */
 
 typedef struct
@@ -385,6 +442,9 @@ typedef struct
     int   c_ungind;       /* ungetch() push index */
     int   c_ungmax;       /* allocated size of ungetch() buffer */
     PDC_PAIR *atrtab;     /* table of color pairs */
+    bool  suspended;      /* TRUE while the screen can't be seen, e.g.
+                             when the window is minimized; doupdate()
+                             leaves the changes in curscr till then */
 } SCREEN;
 
 /*----------------------------------------------------------------------
@@ -1333,6 +1393,7 @@ PDCEX  bool    wmouse_trafo(const WINDOW *, int *, int *, bool);
 
 PDCEX  int     addrawch(chtype);
 PDCEX  int     insrawch(chtype);
+PDCEX  bool    is_static(const WINDOW *);
 PDCEX  bool    is_termresized(void);
 PDCEX  int     mvaddrawch(int, int, chtype);
 PDCEX  int     mvdeleteln(int, int);
@@ -1348,6 +1409,7 @@ PDCEX  WINDOW *resize_window(WINDOW *, int, int);
 PDCEX  int     waddrawch(WINDOW *, chtype);
 PDCEX  int     winsrawch(WINDOW *, chtype);
 PDCEX  char    wordchar(void);
+PDCEX  int     wsetstatic(WINDOW *, bool);
 
 #ifdef PDC_WIDE
 PDCEX  wchar_t *slk_wlabel(int);
@@ -1369,6 +1431,34 @@ PDCEX  int     PDC_setclipboard(const char *, long);
 PDCEX  unsigned long PDC_get_key_modifiers(void);
 PDCEX  int     PDC_return_key_modifiers(bool);
 
+PDCEX  int     PDC_record_input(const char *);
+PDCEX  int     PDC_replay_input(const char *, bool);
+
+PDCEX  int     PDC_get_stats(PDC_STATS *);
+PDCEX  void    PDC_reset_stats(void);
+
+PDCEX  unsigned long PDC_trace_filter(unsigned long);
+PDCEX  int     PDC_trace_dump(const char *);
+
+PDCEX  int     PDC_lazy_erase(WINDOW *, bool);
+PDCEX  int     PDC_wdelnch(WINDOW *, int);
+
+PDCEX  PDC_SNAPSHOT *PDC_snapshot(WINDOW *);
+PDCEX  int     PDC_restore_snapshot(WINDOW *, const PDC_SNAPSHOT *);
+PDCEX  void    PDC_free_snapshot(PDC_SNAPSHOT *);
+PDCEX  WINDOW *PDC_newpad_paged(int, int);
+PDCEX  WINDOW *PDC_newpad_provider(int, int, PDC_LINEPROC, void *);
+PDCEX  WINDOW *PDC_newwin_provider(int, int, int, int, PDC_LINEPROC, void *);
+PDCEX  int     PDC_provider_cache(WINDOW *, int);
+PDCEX  int     PDC_provider_lines(WINDOW *, int);
+PDCEX  int     PDC_provider_scroll(WINDOW *, int);
+PDCEX  int     PDC_provider_top(WINDOW *);
+PDCEX  int     PDC_arena_begin(void);
+PDCEX  int     PDC_arena_end(void);
+PDCEX  void    PDC_pool_trim(void);
+PDCEX  int     PDC_begin_batch(void);
+PDCEX  int     PDC_end_batch(void);
+
 #ifdef XCURSES
 PDCEX  WINDOW *Xinitscr(int, char **);
 PDCEX  void    XCursesExit(void);
@@ -40,6 +40,7 @@ typedef struct           /* structure for ripped off lines */
 #define _SUBWIN    0x01  /* window is a subwindow */
 #define _PAD       0x10  /* X/Open Pad. */
 #define _SUBPAD    0x20  /* X/Open subpad. */
+#define _STATIC    0x40  /* set by wsetstatic() */
 
 /* Miscellaneous */
 
@@ -87,26 +88,192 @@ const char *PDC_sysname(void);
 
 /* Internal cross-module functions */
 
+bool    PDC_advance_clock(int);
+bool    PDC_arena_add(WINDOW *);
+void    PDC_arena_forget(WINDOW *);
+bool    PDC_check_input(void);
+int     PDC_cow_dup(WINDOW *, WINDOW *);
+void    PDC_cow_own(WINDOW *, int, int);
+void    PDC_cow_release(WINDOW *);
+void    PDC_cow_rotate(WINDOW *, int, int, int);
+void    PDC_cow_write(WINDOW *, int);
+void    PDC_fill(chtype *, chtype, int);
+void    PDC_freewin(WINDOW *);
+int     PDC_get_input(void);
 void    PDC_init_atrtab(void);
+void    PDC_lazy_flush(WINDOW *);
+void    PDC_lazy_resolve(WINDOW *, int);
+void    PDC_lazy_write(WINDOW *, int, int, int);
 WINDOW *PDC_makelines(WINDOW *);
 WINDOW *PDC_makenew(int, int, int, int);
+WINDOW *PDC_makepages(WINDOW *);
 int     PDC_mouse_in_slk(int, int);
+bool    PDC_page_clear(WINDOW *, int);
+void    PDC_page_free(WINDOW *);
+void    PDC_page_write(WINDOW *, int);
+void   *PDC_pool_alloc(size_t);
+void    PDC_pool_free(void *);
+size_t  PDC_pool_size(const void *);
+void    PDC_printw_free(void);
+void    PDC_provider_free(WINDOW *);
+int     PDC_provider_refresh(WINDOW *);
+int     PDC_provider_show(WINDOW *, int, int);
+void    PDC_replay_init(void);
 void    PDC_slk_free(void);
 void    PDC_slk_initialize(void);
+int     PDC_span(const chtype *, chtype, int);
 void    PDC_sync(WINDOW *);
 
+/* Vector instructions for the bulk cell operations (PDC_fill(),
+   PDC_span(), wbkgd(), overlay() and copywin()), where the target has
+   them */
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define PDC_SSE2
+#elif defined(__wasm_simd128__)
+# include <wasm_simd128.h>
+# define PDC_WASM_SIMD
+#endif
+
+/* Lazy erase state, for windows with PDC_lazy_erase() on (see clear.c).
+   Code that reads or rearranges a window's cells must resolve the lines
+   first; code that writes cells in place reports the columns instead.
+   Subwindows share their ancestors' cells, so for them, these resolve
+   any lazy ancestor. */
+
+#define PDC_LAZY_RUNS 8     /* runs kept per line before resolving it */
+
+typedef struct
+{
+    int nruns;                      /* -1 if not awaiting the erase */
+    int start[PDC_LAZY_RUNS];       /* columns written since the erase */
+    int end[PDC_LAZY_RUNS];
+} PDC_LAZYLINE;
+
+struct _pdc_lazy
+{
+    int pending;            /* number of lines awaiting the erase */
+    chtype blank;           /* background at the time of the erase */
+    PDC_LAZYLINE *line;
+};
+
+#define PDC_LAZY_FLUSH(win) \
+    if ((win)->_lazy || (win)->_parent) PDC_lazy_flush(win)
+#define PDC_LAZY_RESOLVE(win, y) \
+    if ((win)->_lazy || (win)->_parent) PDC_lazy_resolve(win, y)
+#define PDC_LAZY_WRITE(win, y, x1, x2) \
+    if ((win)->_lazy || (win)->_parent) PDC_lazy_write(win, y, x1, x2)
+
+/* Copy-on-write line sharing, between windows made by dupwin() and
+   snapshots (see snapshot.c). Code that writes a window's cells in
+   place must first unshare the line; after that, the window's line
+   pointer may have changed. Subwindows write to their ancestors'
+   lines, so for them, this unshares the line in any ancestor sharing
+   it. Code that rearranges a window's line pointers must rearrange the
+   shared lines to match. */
+
+typedef struct
+{
+    int refs;           /* windows and snapshots holding the line */
+    int dups;           /* how many of them are dupwin() windows */
+    chtype *cells;
+    WINDOW *owner;      /* the window whose line buffer cells is, or
+                           NULL if it's the line's own */
+} PDC_COWLINE;
+
+struct _pdc_cow
+{
+    int shared;             /* number of lines shared */
+    PDC_COWLINE **line;     /* for each line, or NULL if not shared */
+    WINDOW *next;           /* next window sharing lines */
+    struct _pdc_pages *pages;   /* for a paged pad, instead of line */
+};
+
+/* A paged pad (see pad.c) uses the same hooks. Every line it hasn't
+   written to points to one shared blank line, and gets a line of its
+   own, from a page of them, when first written. */
+
+#define PDC_PAGE_LINES 64   /* lines allocated at a time */
+
+struct _pdc_pages
+{
+    chtype *zero;           /* the shared blank line */
+    chtype blank;           /* what it's filled with */
+    chtype **page;          /* pages allocated */
+    int npages, maxpages;
+    int used;               /* lines used in the last page */
+    chtype **spare;         /* lines given back by PDC_page_clear() */
+    int nspare, maxspare;
+    bool pinned;            /* a subpad may point into the lines */
+};
+
+#define PDC_COW_WRITE(win, y) \
+    if ((win)->_cow || (win)->_parent) PDC_cow_write(win, y)
+#define PDC_COW_ROTATE(win, start, end, dir) \
+    if ((win)->_cow) PDC_cow_rotate(win, start, end, dir)
+#define PDC_PAGE_CLEAR(win, y) \
+    ((win)->_cow && (win)->_cow->pages && PDC_page_clear(win, y))
+
 #ifdef PDC_WIDE
+bool    PDC_mbpartial(const char *, size_t);
 int     PDC_mbtowc(wchar_t *, const char *, size_t);
 size_t  PDC_mbstowcs(wchar_t *, const char *, size_t);
 size_t  PDC_wcstombs(char *, const wchar_t *, size_t);
 #endif
 
+/* PDC_LOG() writes to the text trace file in debug builds, or to the
+   flight recorder ring buffer in builds with PDC_TRACE (see trace.c) */
+
+#define PDC_TRACE_RECORDS 16384     /* size of the ring; a power of 2 */
+
+extern unsigned long pdc_trace_mask;
+extern const char *pdc_trace_file;
+
+void    PDC_trace(const char *, ...);
+void    PDC_trace_init(void);
+
 #ifdef PDCDEBUG
 # define PDC_LOG(x) if (SP && SP->dbfp) PDC_debug x
+#elif defined(PDC_TRACE)
+# define PDC_LOG(x) if (pdc_trace_mask) pdc_trace_file = __FILE__, \
+                                        PDC_trace x
 #else
 # define PDC_LOG(x)
 #endif
 
+/* Stages timed for the benchmarks, when PDC_BENCH is set (see bench.c) */
+
+enum
+{
+    PDC_STAGE_WNOUTREFRESH,
+    PDC_STAGE_DOUPDATE,
+    PDC_STAGE_TRANSFORM,
+    PDC_STAGE_PRESENT,
+    PDC_STAGES
+};
+
+extern bool pdc_bench_on;
+
+void    PDC_bench_begin(int);
+void    PDC_bench_end(int, long);
+void    PDC_bench_init(void);
+void    PDC_bench_report(void);
+
+#define PDC_BENCH_BEGIN(stage) if (pdc_bench_on) PDC_bench_begin(stage)
+#define PDC_BENCH_END(stage, cells) if (pdc_bench_on) \
+                                        PDC_bench_end(stage, cells)
+
+/* Counters for PDC_get_stats() (see stats.c) */
+
+extern PDC_STATS pdc_stats;
+
+#ifdef PDC_NO_STATS
+# define PDC_STAT(field, n) ((void)0)
+#else
+# define PDC_STAT(field, n) (pdc_stats.field += (n))
+#endif
+
 /* Internal macros for attributes */
 
 #ifndef max
@@ -224,6 +224,11 @@ int waddch(WINDOW *win, const chtype ch)
 
         text |= attr;
 
+        PDC_LAZY_WRITE(win, y, x, x);
+
+        if (win->_y[y][x] != text)
+            PDC_COW_WRITE(win, y);
+
         /* Only change _firstch/_lastch if the character to be added is
            different from the character/attribute that is already in
            that position in the window. */
@@ -264,10 +269,7 @@ int waddch(WINDOW *win, const chtype ch)
     win->_curx = x;
     win->_cury = y;
 
-    if (win->_immed)
-        wrefresh(win);
-    if (win->_sync)
-        wsyncup(win);
+    PDC_sync(win);
 
     return OK;
 }
@@ -71,7 +71,7 @@ addchstr
 
 int waddchnstr(WINDOW *win, const chtype *ch, int n)
 {
-    int y, x, maxx, minx;
+    int i, y, x, maxx, minx;
     chtype *ptr;
 
     PDC_LOG(("waddchnstr() - called: win=%p n=%d\n", win, n));
@@ -81,11 +81,23 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
 
     x = win->_curx;
     y = win->_cury;
-    ptr = &(win->_y[y][x]);
 
     if (n == -1 || n > win->_maxx - x)
         n = win->_maxx - x;
 
+    for (i = 0; i < n && ch[i]; i++)
+        ;
+
+    if (i)
+    {
+        PDC_LAZY_WRITE(win, y, x, x + i - 1);
+
+        if (memcmp(win->_y[y] + x, ch, i * sizeof(chtype)))
+            PDC_COW_WRITE(win, y);
+    }
+
+    ptr = &(win->_y[y][x]);
+
     minx = win->_firstch[y];
     maxx = win->_lastch[y];
 
@@ -34,9 +34,11 @@ addstr
    functionality is similar to calling waddch() once for each character
    in the string; except that, when PDCurses is built with wide-
    character support enabled, the narrow-character functions treat the
-   string as a multibyte string in the current locale, and convert it.
-   The routines with n as the last argument write at most n characters;
-   if n is negative, then the entire string will be added.
+   string as a multibyte string in the current locale, and convert it. A
+   byte that doesn't begin a valid character is shown as U+FFFD, the
+   replacement character; but a character cut off by n is left out. The
+   routines with n as the last argument write at most n characters; if n
+   is negative, then the entire string will be added.
 
 ### Return Value
 
@@ -65,33 +67,195 @@ addstr
 
 **man-end****************************************************************/
 
-int waddnstr(WINDOW *win, const char *str, int n)
+#include <string.h>
+
+/* Runs of printable ASCII are the same in any multibyte encoding that
+   PDCurses supports, and need none of waddch()'s special handling, so
+   they're found a word at a time and written directly, without going
+   through PDC_mbtowc() and waddch() for each character. */
+
+#define _ONES ((size_t)-1 / 0xff)      /* 0x0101... */
+#define _HIGHS (_ONES * 0x80)           /* 0x8080... */
+
+/* length of the run of printable ASCII (0x20-0x7e) at the start of str,
+   up to len bytes */
+
+static int _ascii_run(const char *str, int len)
 {
     int i = 0;
 
+    while (len - i >= (int)sizeof(size_t))
+    {
+        size_t w, del;
+
+        memcpy(&w, str + i, sizeof(size_t));
+        del = w ^ (_ONES * 0x7f);
+
+        /* any byte >= 0x80, < 0x20, or == 0x7f */
+
+        if ((w | ((w - _ONES * 0x20) & ~w) | ((del - _ONES) & ~del)) &
+            _HIGHS)
+            break;
+
+        i += sizeof(size_t);
+    }
+
+    while (i < len && str[i] >= ' ' && str[i] < 0x7f)
+        i++;
+
+    return i;
+}
+
+/* write up to len printable ASCII characters at the cursor, stopping
+   short of the last column, which is left to waddch() to handle the
+   wrap; returns the number written */
+
+static int _add_run(WINDOW *win, const char *str, int len)
+{
+    int x = win->_curx, y = win->_cury;
+    int i, first = -1, last = -1;
+    chtype attr, blank, *dest;
+
+    if (y < 0 || y >= win->_maxy || x < 0)
+        return 0;
+
+    if (len > win->_maxx - 1 - x)
+        len = win->_maxx - 1 - x;
+
+    if (len <= 0)
+        return 0;
+
+    /* as in waddch(), for a character with no attributes */
+
+    attr = win->_attrs;
+
+    if (!(attr & A_COLOR))
+        attr |= win->_bkgd & A_ATTRIBUTES;
+    else
+        attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
+
+    blank = (win->_bkgd & A_CHARTEXT) | attr;
+    PDC_LAZY_WRITE(win, y, x, x + len - 1);
+
+    dest = win->_y[y] + x;
+
+    for (i = 0; i < len; i++)
+    {
+        chtype text = (str[i] == ' ') ? blank :
+                      ((unsigned char)str[i] | attr);
+
+        if (dest[i] != text)
+        {
+            if (first < 0)
+            {
+                PDC_COW_WRITE(win, y);
+                dest = win->_y[y] + x;
+                first = i;
+            }
+            last = i;
+            dest[i] = text;
+        }
+    }
+
+    if (first >= 0)
+    {
+        first += x;
+        last += x;
+
+        if (win->_firstch[y] == _NO_CHANGE)
+        {
+            win->_firstch[y] = first;
+            win->_lastch[y] = last;
+        }
+        else
+        {
+            if (first < win->_firstch[y])
+                win->_firstch[y] = first;
+            if (last > win->_lastch[y])
+                win->_lastch[y] = last;
+        }
+    }
+
+    win->_curx = x + len;
+
+    return len;
+}
+
+int waddnstr(WINDOW *win, const char *str, int n)
+{
+    const char *end = NULL;
+    bool bulk = FALSE;
+    int i = 0, len, rc = OK;
+
     PDC_LOG(("waddnstr() - called: string=\"%s\" n %d \n", str, n));
 
     if (!win || !str)
         return ERR;
 
-    while (str[i] && (i < n || n < 0))
+    if (n < 0)
+        len = (int)strlen(str);
+    else
+    {
+        end = memchr(str, 0, n);
+        len = end ? (int)(end - str) : n;
+    }
+
+    while (i < len)
     {
 #ifdef PDC_WIDE
         wchar_t wch;
-        int retval = PDC_mbtowc(&wch, str + i, n >= 0 ? n - i : 6);
+        int retval;
+#else
+        chtype wch;
+#endif
+        int run = _ascii_run(str + i, len - i);
+
+        if (run && (run = _add_run(win, str + i, run)) > 0)
+        {
+            i += run;
+            bulk = TRUE;
+            continue;
+        }
+
+#ifdef PDC_WIDE
+        retval = PDC_mbtowc(&wch, str + i, len - i);
+
+        if (!retval || (retval < 0 && n >= 0 && !end &&
+                        PDC_mbpartial(str + i, len - i)))
+            break;
+
+        /* show a byte that isn't valid as a replacement character, and
+           carry on with the next one -- unless it's the start of a
+           character cut off by n */
 
-        if (retval <= 0)
-            return OK;
+        if (retval < 0)
+        {
+            wch = 0xfffd;
+            retval = 1;
+        }
 
         i += retval;
+
+        /* characters that don't fit in the chtype */
+
+        if ((chtype)wch > A_CHARTEXT)
+            wch = 0xfffd;
 #else
-        chtype wch = (unsigned char)(str[i++]);
+        wch = (unsigned char)(str[i++]);
 #endif
         if (waddch(win, wch) == ERR)
-            return ERR;
+        {
+            rc = ERR;
+            break;
+        }
     }
 
-    return OK;
+    /* waddch() does these itself, but not for the bulk runs */
+
+    if (bulk)
+        PDC_sync(win);
+
+    return rc;
 }
 
 int addstr(const char *str)
@@ -336,6 +336,9 @@ int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
 
     startpos = win->_curx;
     endpos = ((n < 0) ? win->_maxx : min(startpos + n, win->_maxx)) - 1;
+    PDC_LAZY_RESOLVE(win, win->_cury);
+    PDC_COW_WRITE(win, win->_cury);
+
     dest = win->_y[win->_cury];
 
     for (n = startpos; n <= endpos; n++)
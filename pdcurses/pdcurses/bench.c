@@ -0,0 +1,172 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/* Frame timing for the benchmark suite (see ../bench/README.md).
+
+   If the environment variable PDC_BENCH names a file when initscr() is
+   called, the time spent in each stage of screen output is measured,
+   per frame, where a frame ends with each call to doupdate(). The
+   stages are wnoutrefresh() (and pnoutrefresh()), doupdate() as a
+   whole, the PDC_transform_line() calls made by doupdate(), and the
+   final PDC_doupdate() that presents the result. The number of cells
+   copied into curscr and drawn by PDC_transform_line() is also kept.
+
+   When endwin() is called, a summary is appended to the file as one
+   line of JSON, labelled with the value of PDC_BENCH_NAME. Without
+   PDC_BENCH, the only cost is a test of pdc_bench_on at each stage. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+bool pdc_bench_on = FALSE;
+
+static const char *stage_names[PDC_STAGES] =
+{
+    "wnoutrefresh", "doupdate", "transform", "present"
+};
+
+static FILE *benchfp = NULL;
+static const char *bench_name = NULL;
+
+static double stage_start[PDC_STAGES];  /* when each stage was entered */
+static double frame_time[PDC_STAGES];   /* time in this frame, in ns */
+static long stage_calls[PDC_STAGES];
+static long stage_cells[PDC_STAGES];
+
+static double *frames = NULL;   /* PDC_STAGES times per frame */
+static long nframes = 0, maxframes = 0;
+
+static double _now(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+#else
+    return clock() * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+static int _compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void _end_frame(void)
+{
+    int i;
+
+    if (nframes == maxframes)
+    {
+        long newmax = maxframes ? maxframes * 2 : 1024;
+        double *tmp = realloc(frames, newmax * PDC_STAGES * sizeof(double));
+
+        if (!tmp)
+            return;
+
+        frames = tmp;
+        maxframes = newmax;
+    }
+
+    for (i = 0; i < PDC_STAGES; i++)
+    {
+        frames[nframes * PDC_STAGES + i] = frame_time[i];
+        frame_time[i] = 0;
+    }
+
+    nframes++;
+}
+
+void PDC_bench_init(void)
+{
+    const char *env = getenv("PDC_BENCH");
+
+    if (!env || benchfp)
+        return;
+
+    benchfp = fopen(env, "a");
+    if (!benchfp)
+        return;
+
+    bench_name = getenv("PDC_BENCH_NAME");
+    pdc_bench_on = TRUE;
+}
+
+void PDC_bench_begin(int stage)
+{
+    stage_start[stage] = _now();
+}
+
+void PDC_bench_end(int stage, long cells)
+{
+    frame_time[stage] += _now() - stage_start[stage];
+    stage_calls[stage]++;
+    stage_cells[stage] += cells;
+
+    if (stage == PDC_STAGE_DOUPDATE)
+        _end_frame();
+}
+
+/* write the summary for the frames so far, and start over */
+
+void PDC_bench_report(void)
+{
+    double *sorted;
+    int i;
+    long j;
+
+    if (!pdc_bench_on)
+        return;
+
+    sorted = malloc((nframes + 1) * sizeof(double));
+    if (!sorted)
+        return;
+
+    fprintf(benchfp, "{\"name\": \"%s\", \"frames\": %ld, "
+            "\"cells_copied\": %ld, \"cells_drawn\": %ld, \"bytes\": %ld",
+            bench_name ? bench_name : "", nframes,
+            stage_cells[PDC_STAGE_WNOUTREFRESH],
+            stage_cells[PDC_STAGE_TRANSFORM],
+            (long)((stage_cells[PDC_STAGE_WNOUTREFRESH] +
+                    stage_cells[PDC_STAGE_TRANSFORM]) * sizeof(chtype)));
+
+    for (i = 0; i < PDC_STAGES; i++)
+    {
+        double total = 0;
+
+        for (j = 0; j < nframes; j++)
+        {
+            sorted[j] = frames[j * PDC_STAGES + i] / 1000;
+            total += sorted[j];
+        }
+
+        qsort(sorted, nframes, sizeof(double), _compare);
+
+        fprintf(benchfp, ", \"%s\": {\"calls\": %ld, \"total_us\": %.1f",
+                stage_names[i], stage_calls[i], total);
+
+        if (nframes)
+            fprintf(benchfp, ", \"mean_us\": %.2f, \"min_us\": %.2f, "
+                    "\"p50_us\": %.2f, \"p95_us\": %.2f, \"p99_us\": %.2f, "
+                    "\"max_us\": %.2f", total / nframes, sorted[0],
+                    sorted[nframes / 2], sorted[nframes * 95 / 100],
+                    sorted[nframes * 99 / 100], sorted[nframes - 1]);
+
+        fprintf(benchfp, "}");
+
+        stage_calls[i] = 0;
+        stage_cells[i] = 0;
+    }
+
+    fprintf(benchfp, "}\n");
+    fflush(benchfp);
+
+    free(sorted);
+    nframes = 0;
+}
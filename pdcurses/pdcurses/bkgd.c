@@ -65,80 +65,169 @@ bkgd
 
 **man-end****************************************************************/
 
-int wbkgd(WINDOW *win, chtype ch)
+/* The values that wbkgd() applies to each cell */
+
+typedef struct
+{
+    chtype oldcolr, newcolr;    /* background color, before and after */
+    chtype oldattr, newattr;    /* other background attributes */
+    chtype oldch, newch;        /* background character */
+} _BKGD;
+
+/* what follows is what seems to occur in the System V implementation
+   of this routine: if the color of a cell is the same as the old
+   background color, make it the new background color, otherwise leave
+   it; remove any attributes (non color) that were part of the old
+   background, then combine the remaining ones with the new background;
+   and change the character if it's there because it was the old
+   background character. This is done without branches, as selects by
+   mask, four cells at a time where there are vector instructions.
+   Returns nonzero if any cell in the line changed. */
+
+static chtype _bkgd_line(chtype *ptr, int n, const _BKGD *b)
 {
-    int x, y;
-    chtype oldcolr, oldch, newcolr, newch, colr, attr;
-    chtype oldattr = 0, newattr = 0;
-    chtype *winptr;
+    chtype changed = 0;
+    int x = 0;
 
-    PDC_LOG(("wbkgd() - called\n"));
+#if defined(PDC_SSE2)
+    if (sizeof(chtype) == 4)
+    {
+        __m128i colmask = _mm_set1_epi32((int)A_COLOR);
+        __m128i attmask = _mm_set1_epi32((int)(A_ATTRIBUTES ^ A_COLOR));
+        __m128i chmask = _mm_set1_epi32((int)A_CHARTEXT);
+        __m128i oldcolr = _mm_set1_epi32((int)b->oldcolr);
+        __m128i newcolr = _mm_set1_epi32((int)b->newcolr);
+        __m128i oldattr = _mm_set1_epi32((int)b->oldattr);
+        __m128i newattr = _mm_set1_epi32((int)b->newattr);
+        __m128i oldch = _mm_set1_epi32((int)b->oldch);
+        __m128i newch = _mm_set1_epi32((int)b->newch);
+        __m128i diff = _mm_setzero_si128();
+
+        for (; x + 4 <= n; x += 4)
+        {
+            __m128i v = _mm_loadu_si128((__m128i *)(ptr + x));
+            __m128i colr = _mm_and_si128(v, colmask);
+            __m128i text = _mm_and_si128(v, chmask);
+            __m128i attr = _mm_and_si128(v, attmask);
+            __m128i sel, res;
 
-    if (!win)
-        return ERR;
+            sel = _mm_cmpeq_epi32(colr, oldcolr);
+            colr = _mm_or_si128(_mm_andnot_si128(sel, colr),
+                                _mm_and_si128(sel, newcolr));
 
-    if (win->_bkgd == ch)
-        return OK;
+            attr = _mm_or_si128(_mm_xor_si128(attr, oldattr), newattr);
 
-    oldcolr = win->_bkgd & A_COLOR;
-    if (oldcolr)
-        oldattr = (win->_bkgd & A_ATTRIBUTES) ^ oldcolr;
+            sel = _mm_cmpeq_epi32(text, oldch);
+            text = _mm_or_si128(_mm_andnot_si128(sel, text),
+                                _mm_and_si128(sel, newch));
 
-    oldch = win->_bkgd & A_CHARTEXT;
+            res = _mm_or_si128(_mm_or_si128(text, attr), colr);
+            diff = _mm_or_si128(diff, _mm_xor_si128(res, v));
 
-    wbkgdset(win, ch);
+            _mm_storeu_si128((__m128i *)(ptr + x), res);
+        }
 
-    newcolr = win->_bkgd & A_COLOR;
-    if (newcolr)
-        newattr = (win->_bkgd & A_ATTRIBUTES) ^ newcolr;
+        changed = (chtype)(_mm_movemask_epi8(_mm_cmpeq_epi32(diff,
+                           _mm_setzero_si128())) != 0xffff);
+    }
+#elif defined(PDC_WASM_SIMD)
+    if (sizeof(chtype) == 4)
+    {
+        v128_t colmask = wasm_i32x4_splat((int)A_COLOR);
+        v128_t attmask = wasm_i32x4_splat((int)(A_ATTRIBUTES ^ A_COLOR));
+        v128_t chmask = wasm_i32x4_splat((int)A_CHARTEXT);
+        v128_t oldcolr = wasm_i32x4_splat((int)b->oldcolr);
+        v128_t newcolr = wasm_i32x4_splat((int)b->newcolr);
+        v128_t oldattr = wasm_i32x4_splat((int)b->oldattr);
+        v128_t newattr = wasm_i32x4_splat((int)b->newattr);
+        v128_t oldch = wasm_i32x4_splat((int)b->oldch);
+        v128_t newch = wasm_i32x4_splat((int)b->newch);
+        v128_t diff = wasm_i32x4_splat(0);
+
+        for (; x + 4 <= n; x += 4)
+        {
+            v128_t v = wasm_v128_load(ptr + x);
+            v128_t colr = wasm_v128_and(v, colmask);
+            v128_t text = wasm_v128_and(v, chmask);
+            v128_t attr = wasm_v128_and(v, attmask);
+            v128_t res;
+
+            colr = wasm_v128_bitselect(newcolr, colr,
+                                       wasm_i32x4_eq(colr, oldcolr));
+            attr = wasm_v128_or(wasm_v128_xor(attr, oldattr), newattr);
+            text = wasm_v128_bitselect(newch, text,
+                                       wasm_i32x4_eq(text, oldch));
+
+            res = wasm_v128_or(wasm_v128_or(text, attr), colr);
+            diff = wasm_v128_or(diff, wasm_v128_xor(res, v));
+
+            wasm_v128_store(ptr + x, res);
+        }
 
-    newch = win->_bkgd & A_CHARTEXT;
+        changed = (chtype)wasm_v128_any_true(diff);
+    }
+#endif
+    for (; x < n; x++)
+    {
+        chtype ch = ptr[x];
+        chtype colr = ch & A_COLOR;
+        chtype text = ch & A_CHARTEXT;
+        chtype sel;
 
-    /* what follows is what seems to occur in the System V
-       implementation of this routine */
+        sel = (chtype)0 - (colr == b->oldcolr);
+        colr = (colr & ~sel) | (b->newcolr & sel);
 
-    for (y = 0; y < win->_maxy; y++)
-    {
-        for (x = 0; x < win->_maxx; x++)
-        {
-            winptr = win->_y[y] + x;
+        sel = (chtype)0 - (text == b->oldch);
+        text = (text & ~sel) | (b->newch & sel);
 
-            ch = *winptr;
+        ch = text | colr | (((ch & (A_ATTRIBUTES ^ A_COLOR)) ^
+                             b->oldattr) | b->newattr);
+
+        changed |= ch ^ ptr[x];
+        ptr[x] = ch;
+    }
 
-            /* determine the colors and attributes of the character read
-               from the window */
+    return changed;
+}
+
+int wbkgd(WINDOW *win, chtype ch)
+{
+    int y;
+    _BKGD b;
 
-            colr = ch & A_COLOR;
-            attr = ch & (A_ATTRIBUTES ^ A_COLOR);
+    PDC_LOG(("wbkgd() - called\n"));
 
-            /* if the color is the same as the old background color,
-               then make it the new background color, otherwise leave it */
+    if (!win)
+        return ERR;
 
-            if (colr == oldcolr)
-                colr = newcolr;
+    if (win->_bkgd == ch)
+        return OK;
 
-            /* remove any attributes (non color) from the character that
-               were part of the old background, then combine the
-               remaining ones with the new background */
+    b.oldcolr = win->_bkgd & A_COLOR;
+    b.oldattr = b.oldcolr ? (win->_bkgd & A_ATTRIBUTES) ^ b.oldcolr : 0;
+    b.oldch = win->_bkgd & A_CHARTEXT;
 
-            attr ^= oldattr;
-            attr |= newattr;
+    wbkgdset(win, ch);
 
-            /* change character if it is there because it was the old
-               background character */
+    b.newcolr = win->_bkgd & A_COLOR;
+    b.newattr = b.newcolr ? (win->_bkgd & A_ATTRIBUTES) ^ b.newcolr : 0;
+    b.newch = win->_bkgd & A_CHARTEXT;
 
-            ch &= A_CHARTEXT;
-            if (ch == oldch)
-                ch = newch;
+    PDC_LAZY_FLUSH(win);
 
-            ch |= (attr | colr);
+    /* only the lines that changed need to be refreshed */
 
-            *winptr = ch;
+    for (y = 0; y < win->_maxy; y++)
+    {
+        PDC_COW_WRITE(win, y);
 
+        if (_bkgd_line(win->_y[y], win->_maxx, &b))
+        {
+            win->_firstch[y] = 0;
+            win->_lastch[y] = win->_maxx - 1;
         }
     }
 
-    touchwin(win);
     PDC_sync(win);
     return OK;
 }
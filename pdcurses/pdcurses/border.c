@@ -138,6 +138,39 @@ static chtype _attr_passthru(WINDOW *win, chtype ch)
     return ch;
 }
 
+/* _set_cells() -- Sets n cells of line y, from column x, to ch. Only
+   the cells from the first one that actually changes are marked as
+   changed, so redrawing a border or line that's already there (as after
+   a lazy erase) leaves nothing to refresh. */
+
+static void _set_cells(WINDOW *win, int y, int x, chtype ch, int n)
+{
+    chtype *ptr = win->_y[y] + x;
+    int i;
+
+    if (n < 1)
+        return;
+
+    PDC_LAZY_WRITE(win, y, x, x + n - 1);
+
+    for (i = 0; i < n && ptr[i] == ch; i++)
+        ;
+
+    if (i == n)
+        return;
+
+    PDC_COW_WRITE(win, y);
+
+    ptr = win->_y[y] + x;
+    PDC_fill(ptr + i, ch, n - i);
+
+    if (x + i < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
+        win->_firstch[y] = x + i;
+
+    if (x + n - 1 > win->_lastch[y])
+        win->_lastch[y] = x + n - 1;
+}
+
 int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
             chtype tl, chtype tr, chtype bl, chtype br)
 {
@@ -160,28 +193,19 @@ int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
     bl = _attr_passthru(win, bl ? bl : ACS_LLCORNER);
     br = _attr_passthru(win, br ? br : ACS_LRCORNER);
 
-    for (i = 1; i < xmax; i++)
-    {
-        win->_y[0][i] = ts;
-        win->_y[ymax][i] = bs;
-    }
+    _set_cells(win, 0, 1, ts, xmax - 1);
+    _set_cells(win, ymax, 1, bs, xmax - 1);
 
     for (i = 1; i < ymax; i++)
     {
-        win->_y[i][0] = ls;
-        win->_y[i][xmax] = rs;
+        _set_cells(win, i, 0, ls, 1);
+        _set_cells(win, i, xmax, rs, 1);
     }
 
-    win->_y[0][0] = tl;
-    win->_y[0][xmax] = tr;
-    win->_y[ymax][0] = bl;
-    win->_y[ymax][xmax] = br;
-
-    for (i = 0; i <= ymax; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = xmax;
-    }
+    _set_cells(win, 0, 0, tl, 1);
+    _set_cells(win, 0, xmax, tr, 1);
+    _set_cells(win, ymax, 0, bl, 1);
+    _set_cells(win, ymax, xmax, br, 1);
 
     PDC_sync(win);
 
@@ -205,7 +229,6 @@ int box(WINDOW *win, chtype verch, chtype horch)
 
 int whline(WINDOW *win, chtype ch, int n)
 {
-    chtype *dest;
     int startpos, endpos;
 
     PDC_LOG(("whline() - called\n"));
@@ -215,19 +238,9 @@ int whline(WINDOW *win, chtype ch, int n)
 
     startpos = win->_curx;
     endpos = min(startpos + n, win->_maxx) - 1;
-    dest = win->_y[win->_cury];
     ch = _attr_passthru(win, ch ? ch : ACS_HLINE);
 
-    for (n = startpos; n <= endpos; n++)
-        dest[n] = ch;
-
-    n = win->_cury;
-
-    if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-        win->_firstch[n] = startpos;
-
-    if (endpos > win->_lastch[n])
-        win->_lastch[n] = endpos;
+    _set_cells(win, win->_cury, startpos, ch, endpos - startpos + 1);
 
     PDC_sync(win);
 
@@ -276,15 +289,7 @@ int wvline(WINDOW *win, chtype ch, int n)
     ch = _attr_passthru(win, ch ? ch : ACS_VLINE);
 
     for (n = win->_cury; n < endpos; n++)
-    {
-        win->_y[n][x] = ch;
-
-        if (x < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-            win->_firstch[n] = x;
-
-        if (x > win->_lastch[n])
-            win->_lastch[n] = x;
-    }
+        _set_cells(win, n, x, ch, 1);
 
     PDC_sync(win);
 
@@ -18,6 +18,8 @@ clear
     int clrtoeol(void);
     int wclrtoeol(WINDOW *win);
 
+    int PDC_lazy_erase(WINDOW *win, bool bf);
+
 ### Description
 
    erase() and werase() copy blanks (i.e. the background chtype) to
@@ -33,6 +35,18 @@ clear
    clrtoeol() and wclrtoeol() clear the window from the current cursor
    position to the end of the current line.
 
+   PDC_lazy_erase() turns lazy erasing on or off for the window. While
+   it's on, werase() and wclear() (and wclrtobot() from the top left
+   corner) leave the cells as they are, and only note that each line is
+   to be blanked. Cells written after that are remembered, and at the
+   next wnoutrefresh(), or whenever a line is read back, the cells that
+   weren't rewritten are blanked. Because a cell rewritten with what it
+   already held doesn't count as a change, erasing a window and drawing
+   almost the same contents again costs about as much as drawing only
+   the differences. It can't be used on subwindows; a window with lazy
+   erasing should be accessed only through the curses functions, not
+   via its _y array.
+
 ### Return Value
 
    All functions return OK on success and ERR on error.
@@ -49,13 +63,286 @@ clear
    wclrtobot             |    Y   |    Y    |   Y
    clrtoeol              |    Y   |    Y    |   Y
    wclrtoeol             |    Y   |    Y    |   Y
+   PDC_lazy_erase        |    -   |    -    |   -
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
+
+/* PDC_fill() -- set n cells from dest to ch; eight at a time with
+   vector stores where the target has them, since this is under every
+   erase, clear and line-drawing call. */
+
+void PDC_fill(chtype *dest, chtype ch, int n)
+{
+#if defined(PDC_SSE2)
+    if (sizeof(chtype) == 4)
+    {
+        __m128i v = _mm_set1_epi32((int)ch);
+
+        for (; n >= 8; n -= 8, dest += 8)
+        {
+            _mm_storeu_si128((__m128i *)dest, v);
+            _mm_storeu_si128((__m128i *)(dest + 4), v);
+        }
+    }
+#elif defined(PDC_WASM_SIMD)
+    if (sizeof(chtype) == 4)
+    {
+        v128_t v = wasm_i32x4_splat((int)ch);
+
+        for (; n >= 8; n -= 8, dest += 8)
+        {
+            wasm_v128_store(dest, v);
+            wasm_v128_store(dest + 4, v);
+        }
+    }
+#endif
+    while (n-- > 0)
+        *dest++ = ch;
+}
+
+/* PDC_span() -- the number of cells from src, up to n, that are equal
+   to ch; compared four at a time where PDC_fill() uses vectors */
+
+int PDC_span(const chtype *src, chtype ch, int n)
+{
+    int i = 0;
+
+#if defined(PDC_SSE2)
+    if (sizeof(chtype) == 4)
+    {
+        __m128i v = _mm_set1_epi32((int)ch);
+
+        for (; i + 4 <= n; i += 4)
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(v,
+                _mm_loadu_si128((const __m128i *)(src + i)))) != 0xffff)
+                break;
+    }
+#elif defined(PDC_WASM_SIMD)
+    if (sizeof(chtype) == 4)
+    {
+        v128_t v = wasm_i32x4_splat((int)ch);
+
+        for (; i + 4 <= n; i += 4)
+            if (!wasm_i32x4_all_true(wasm_i32x4_eq(v,
+                wasm_v128_load(src + i))))
+                break;
+    }
+#endif
+    while (i < n && src[i] == ch)
+        i++;
+
+    return i;
+}
+
+/* Lazy erase. A line awaiting the erase keeps its old cells, plus up to
+   PDC_LAZY_RUNS runs of columns written since. Resolving it blanks the
+   cells outside the runs, marking those that weren't already blank as
+   changed. */
+
+static void _lazy_resolve(WINDOW *win, int y)
+{
+    struct _pdc_lazy *lazy = win->_lazy;
+    PDC_LAZYLINE *ln = lazy->line + y;
+    chtype blank = lazy->blank, *ptr = win->_y[y];
+    int i, j, x, stop, first = -1, last = -1;
+
+    /* sort the runs by their starting column */
+
+    for (i = 1; i < ln->nruns; i++)
+        for (j = i; j && ln->start[j - 1] > ln->start[j]; j--)
+        {
+            int tmp = ln->start[j];
+
+            ln->start[j] = ln->start[j - 1];
+            ln->start[j - 1] = tmp;
+
+            tmp = ln->end[j];
+            ln->end[j] = ln->end[j - 1];
+            ln->end[j - 1] = tmp;
+        }
+
+    /* blank the gaps between them, marking from the first cell that
+       wasn't blank to the end of the gap as changed */
+
+    for (i = 0, x = 0; i <= ln->nruns; i++)
+    {
+        stop = (i < ln->nruns) ? ln->start[i] : win->_maxx;
+
+        if (x < stop)
+        {
+            x += PDC_span(ptr + x, blank, stop - x);
+
+            if (x < stop)
+            {
+                if (first < 0)
+                {
+                    PDC_COW_WRITE(win, y);
+                    ptr = win->_y[y];
+                }
+
+                PDC_fill(ptr + x, blank, stop - x);
+
+                if (first < 0)
+                    first = x;
+                last = stop - 1;
+            }
+        }
+
+        if (i < ln->nruns && ln->end[i] >= x)
+            x = ln->end[i] + 1;
+    }
+
+    if (first >= 0)
+    {
+        if (win->_firstch[y] == _NO_CHANGE || first < win->_firstch[y])
+            win->_firstch[y] = first;
+        if (last > win->_lastch[y])
+            win->_lastch[y] = last;
+    }
+
+    ln->nruns = -1;
+    lazy->pending--;
+}
+
+/* for a subwindow, resolve every line of any lazy ancestor */
+
+static void _lazy_ancestors(WINDOW *win)
+{
+    for (win = win->_parent; win; win = win->_parent)
+        if (win->_lazy && win->_lazy->pending)
+            PDC_lazy_flush(win);
+}
+
+void PDC_lazy_flush(WINDOW *win)
+{
+    int y;
+
+    if (!win->_lazy)
+    {
+        _lazy_ancestors(win);
+        return;
+    }
+
+    for (y = 0; win->_lazy->pending && y < win->_maxy; y++)
+        if (win->_lazy->line[y].nruns >= 0)
+            _lazy_resolve(win, y);
+}
+
+void PDC_lazy_resolve(WINDOW *win, int y)
+{
+    if (!win->_lazy)
+        _lazy_ancestors(win);
+    else if (win->_lazy->line[y].nruns >= 0)
+        _lazy_resolve(win, y);
+}
+
+/* note that columns x1 to x2 of line y are about to be written */
+
+void PDC_lazy_write(WINDOW *win, int y, int x1, int x2)
+{
+    PDC_LAZYLINE *ln;
+    int i;
+
+    if (!win->_lazy)
+    {
+        _lazy_ancestors(win);
+        return;
+    }
+
+    ln = win->_lazy->line + y;
+    i = ln->nruns - 1;
+
+    if (i < 0)
+    {
+        if (ln->nruns < 0)
+            return;
+    }
+    else if (x1 <= ln->end[i] + 1 && x2 >= ln->start[i] - 1)
+    {
+        /* extend the last run, which is the usual case */
+
+        if (x1 < ln->start[i])
+            ln->start[i] = x1;
+        if (x2 > ln->end[i])
+            ln->end[i] = x2;
+
+        if (!ln->start[i] && ln->end[i] >= win->_maxx - 1)
+        {
+            /* the whole line has been rewritten */
+
+            ln->nruns = -1;
+            win->_lazy->pending--;
+        }
+
+        return;
+    }
+
+    if (ln->nruns == PDC_LAZY_RUNS)
+    {
+        _lazy_resolve(win, y);
+        return;
+    }
+
+    ln->start[ln->nruns] = x1;
+    ln->end[ln->nruns] = x2;
+    ln->nruns++;
+
+    if (!x1 && x2 >= win->_maxx - 1)
+    {
+        ln->nruns = -1;
+        win->_lazy->pending--;
+    }
+}
+
+int PDC_lazy_erase(WINDOW *win, bool bf)
+{
+    struct _pdc_lazy *lazy;
+    int y;
+
+    PDC_LOG(("PDC_lazy_erase() - called: win=%p bf=%d\n", win, bf));
+
+    if (!win || win->_parent || win == curscr)
+        return ERR;
+
+    if (bf && !win->_lazy)
+    {
+        lazy = malloc(sizeof(struct _pdc_lazy));
+        if (!lazy)
+            return ERR;
+
+        lazy->line = malloc(win->_maxy * sizeof(PDC_LAZYLINE));
+        if (!lazy->line)
+        {
+            free(lazy);
+            return ERR;
+        }
+
+        PDC_STAT(allocs, 2);
+
+        for (y = 0; y < win->_maxy; y++)
+            lazy->line[y].nruns = -1;
+
+        lazy->pending = 0;
+        lazy->blank = win->_bkgd;
+        win->_lazy = lazy;
+    }
+    else if (!bf && win->_lazy)
+    {
+        PDC_lazy_flush(win);
+
+        free(win->_lazy->line);
+        free(win->_lazy);
+        win->_lazy = NULL;
+    }
+
+    return OK;
+}
+
 int wclrtoeol(WINDOW *win)
 {
-    int x, y, minx;
-    chtype blank, *ptr;
+    int x, y;
 
     PDC_LOG(("wclrtoeol() - called: Row: %d Col: %d\n",
              win->_cury, win->_curx));
@@ -66,12 +353,12 @@ int wclrtoeol(WINDOW *win)
     y = win->_cury;
     x = win->_curx;
 
-    /* wrs (4/10/93) account for window background */
+    PDC_LAZY_WRITE(win, y, x, win->_maxx - 1);
+    PDC_COW_WRITE(win, y);
 
-    blank = win->_bkgd;
+    /* wrs (4/10/93) account for window background */
 
-    for (minx = x, ptr = &win->_y[y][x]; minx < win->_maxx; minx++, ptr++)
-        *ptr = blank;
+    PDC_fill(win->_y[y] + x, win->_bkgd, win->_maxx - x);
 
     if (x < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
         win->_firstch[y] = x;
@@ -91,28 +378,49 @@ int clrtoeol(void)
 
 int wclrtobot(WINDOW *win)
 {
-    int savey, savex;
+    int x, y;
 
     PDC_LOG(("wclrtobot() - called\n"));
 
     if (!win)
         return ERR;
 
-    savey = win->_cury;
-    savex = win->_curx;
-
     /* should this involve scrolling region somehow ? */
 
-    if (win->_cury + 1 < win->_maxy)
+    if (win->_lazy && !win->_cury && !win->_curx)
     {
-        win->_curx = 0;
-        win->_cury++;
-        for (; win->_maxy > win->_cury; win->_cury++)
-            wclrtoeol(win);
-        win->_cury = savey;
-        win->_curx = savex;
+        /* leave the cells for PDC_lazy_resolve() */
+
+        for (y = 0; y < win->_maxy; y++)
+            win->_lazy->line[y].nruns = 0;
+
+        win->_lazy->pending = win->_maxy;
+        win->_lazy->blank = win->_bkgd;
+
+        PDC_sync(win);
+        return OK;
+    }
+
+    /* clear to the end of the current line, then the whole of each line
+       below it, in one pass, with a single PDC_sync() at the end */
+
+    for (y = win->_cury, x = win->_curx; y < win->_maxy; y++, x = 0)
+    {
+        PDC_LAZY_WRITE(win, y, x, win->_maxx - 1);
+
+        /* a paged pad can give back a line that's cleared whole */
+
+        if (x || !PDC_PAGE_CLEAR(win, y))
+        {
+            PDC_COW_WRITE(win, y);
+            PDC_fill(win->_y[y] + x, win->_bkgd, win->_maxx - x);
+        }
+
+        if (x < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
+            win->_firstch[y] = x;
+
+        win->_lastch[y] = win->_maxx - 1;
     }
-    wclrtoeol(win);
 
     PDC_sync(win);
     return OK;
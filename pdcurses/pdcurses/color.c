@@ -45,8 +45,9 @@ color
    values of the foreground and background colors. The pair number must
    be between 0 and COLOR_PAIRS - 1, inclusive. The foreground and
    background must be between 0 and COLORS - 1, inclusive. If the color
-   pair was previously initialized, the screen is refreshed, and all
-   occurrences of that color-pair are changed to the new definition.
+   pair was previously initialized, all occurrences of that color-pair
+   on the screen are changed to the new definition at the next refresh;
+   only those cells are drawn again.
 
    pair_content() is used to determine what the colors of a given color-
    pair consist of.
@@ -56,7 +57,9 @@ color
 
    init_color() is used to redefine a color, if possible. Each of the
    components -- red, green, and blue -- is specified in a range from 0
-   to 1000, inclusive.
+   to 1000, inclusive. The cells on the screen in the color are drawn
+   again at the next refresh, or napms() -- only those, so fading one
+   color in steps is cheap.
 
    color_content() reports the current definition of a color in the same
    format as used by init_color().
@@ -149,20 +152,76 @@ static void _normalize(short *fg, short *bg)
         *bg = SP->orig_attr ? SP->orig_back : COLOR_BLACK;
 }
 
+/* Make the next doupdate() draw again the cells on the screen that use
+   the color pairs marked in pairs -- and, if lines is TRUE, those with
+   lines drawn in SP->line_color -- rather than the whole screen. Rather
+   than keep an index of where each pair is used, which would cost
+   something for every cell written, SP->lastscr is searched for them;
+   that's much cheaper than drawing it all. Each cell found is set there
+   to a value that can't match, as initscr() does for all of them. */
+
+static void _redraw_pairs(const bool *pairs, bool lines)
+{
+    chtype *last, mask = lines ? (A_UNDERLINE|A_LEFT|A_RIGHT) : 0;
+    int y, x, first, end;
+
+    if (!SP->lastscr || curscr->_clear)
+        return;
+
+    for (x = 0; x < PDC_COLOR_PAIRS && !pairs[x]; x++)
+        ;
+
+    if (x == PDC_COLOR_PAIRS && !mask)
+        return;
+
+    for (y = 0; y < SP->lines; y++)
+    {
+        last = SP->lastscr->_y[y];
+        first = -1;
+        end = 0;
+
+        for (x = 0; x < SP->cols; x++)
+            if (pairs[PAIR_NUMBER(last[x])] || (last[x] & mask))
+            {
+                last[x] = (chtype)(-1);
+
+                if (first < 0)
+                    first = x;
+                end = x;
+            }
+
+        if (first >= 0)
+        {
+            if (curscr->_firstch[y] == _NO_CHANGE ||
+                curscr->_firstch[y] > first)
+                curscr->_firstch[y] = first;
+
+            if (curscr->_lastch[y] < end)
+                curscr->_lastch[y] = end;
+        }
+    }
+}
+
 static void _init_pair_core(short pair, short fg, short bg)
 {
     PDC_PAIR *p = SP->atrtab + pair;
+    bool pairs[PDC_COLOR_PAIRS];
 
     _normalize(&fg, &bg);
 
-    /* To allow the PDC_PRESERVE_SCREEN option to work, we only reset
-       curscr if this call to init_pair() alters a color pair created by
-       the user. */
+    /* To allow the PDC_PRESERVE_SCREEN option to work, we only redraw
+       the cells of the pair if this call to init_pair() alters a color
+       pair created by the user. */
 
     if (p->set)
     {
         if (p->f != fg || p->b != bg)
-            curscr->_clear = TRUE;
+        {
+            memset(pairs, 0, sizeof(pairs));
+            pairs[pair] = TRUE;
+
+            _redraw_pairs(pairs, FALSE);
+        }
     }
 
     p->f = fg;
@@ -193,6 +252,10 @@ bool has_colors(void)
 
 int init_color(short color, short red, short green, short blue)
 {
+    bool pairs[PDC_COLOR_PAIRS];
+    short dim;
+    int i;
+
     PDC_LOG(("init_color() - called\n"));
 
     if (!SP || color < 0 || color >= COLORS || !PDC_can_change_color() ||
@@ -200,6 +263,21 @@ int init_color(short color, short red, short green, short blue)
         blue < -1 || blue > 1000)
         return ERR;
 
+    /* redraw only the cells in the pairs that use the color -- or whose
+       colors become it when brightened, for A_BOLD or A_BLINK */
+
+    dim = (color >= 8 && color < 16) ? color - 8 : color;
+
+    for (i = 0; i < PDC_COLOR_PAIRS; i++)
+    {
+        PDC_PAIR *p = SP->atrtab + i;
+
+        pairs[i] = p->f == color || p->b == color ||
+                   p->f == dim || p->b == dim;
+    }
+
+    _redraw_pairs(pairs, color == SP->line_color);
+
     SP->dirty = TRUE;
 
     return PDC_init_color(color, red, green, blue);
@@ -14,6 +14,8 @@ delch
     int mvdelch(int y, int x);
     int mvwdelch(WINDOW *win, int y, int x);
 
+    int PDC_wdelnch(WINDOW *win, int n);
+
 ### Description
 
    The character under the cursor in the window is deleted. All
@@ -22,6 +24,9 @@ delch
    The cursor position does not change (after moving to y, x if
    coordinates are specified).
 
+   PDC_wdelnch() deletes n characters starting at the cursor, as n
+   calls to wdelch() would, but shifts the rest of the line only once.
+
 ### Return Value
 
    All functions return OK on success and ERR on error.
@@ -34,33 +39,44 @@ delch
    wdelch                |    Y   |    Y    |   Y
    mvdelch               |    Y   |    Y    |   Y
    mvwdelch              |    Y   |    Y    |   Y
+   PDC_wdelnch           |    -   |    -    |   -
 
 **man-end****************************************************************/
 
 #include <string.h>
 
-int wdelch(WINDOW *win)
+int PDC_wdelnch(WINDOW *win, int n)
 {
     int y, x, maxx;
     chtype *temp1;
 
-    PDC_LOG(("wdelch() - called\n"));
+    PDC_LOG(("PDC_wdelnch() - called: n %d\n", n));
 
-    if (!win)
+    if (!win || n < 0)
         return ERR;
 
     y = win->_cury;
     x = win->_curx;
-    maxx = win->_maxx - 1;
+    maxx = win->_maxx;
+
+    if (n > maxx - x)
+        n = maxx - x;
+
+    if (!n)
+        return OK;
+
+    PDC_LAZY_RESOLVE(win, y);
+    PDC_COW_WRITE(win, y);
+
     temp1 = &win->_y[y][x];
 
-    memmove(temp1, temp1 + 1, (maxx - x) * sizeof(chtype));
+    memmove(temp1, temp1 + n, (maxx - x - n) * sizeof(chtype));
 
     /* wrs (4/10/93) account for window background */
 
-    win->_y[y][maxx] = win->_bkgd;
+    PDC_fill(win->_y[y] + maxx - n, win->_bkgd, n);
 
-    win->_lastch[y] = maxx;
+    win->_lastch[y] = maxx - 1;
 
     if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
         win->_firstch[y] = x;
@@ -70,6 +86,13 @@ int wdelch(WINDOW *win)
     return OK;
 }
 
+int wdelch(WINDOW *win)
+{
+    PDC_LOG(("wdelch() - called\n"));
+
+    return PDC_wdelnch(win, 1);
+}
+
 int delch(void)
 {
     PDC_LOG(("delch() - called\n"));
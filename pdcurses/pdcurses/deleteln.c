@@ -65,12 +65,19 @@ int wdeleteln(WINDOW *win)
     if (!win)
         return ERR;
 
+    PDC_LAZY_FLUSH(win);
+
     /* wrs (4/10/93) account for window background */
 
     blank = win->_bkgd;
 
+    PDC_COW_WRITE(win, win->_cury);
+
     temp = win->_y[win->_cury];
 
+    if (win->_cury <= win->_bmarg)
+        PDC_COW_ROTATE(win, win->_cury, win->_bmarg, 1);
+
     for (y = win->_cury; y < win->_bmarg; y++)
     {
         win->_y[y] = win->_y[y + 1];
@@ -161,10 +168,15 @@ int winsertln(WINDOW *win)
     if (!win)
         return ERR;
 
+    PDC_LAZY_FLUSH(win);
+
     /* wrs (4/10/93) account for window background */
 
     blank = win->_bkgd;
 
+    PDC_COW_WRITE(win, win->_maxy - 1);
+    PDC_COW_ROTATE(win, win->_maxy - 1, win->_cury, -1);
+
     temp = win->_y[win->_maxy - 1];
 
     for (y = win->_maxy - 1; y > win->_cury; y--)
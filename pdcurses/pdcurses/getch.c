@@ -159,9 +159,11 @@ static void _copy(void)
         return;
 
 #ifdef PDC_WIDE
+    PDC_STAT(allocs, 1);
     wtmp = malloc((len + 1) * sizeof(wchar_t));
     len *= 4;
 #endif
+    PDC_STAT(allocs, 1);
     tmp = malloc(len + 1);
 
     for (j = y_start, pos = 0; j <= y_end; j++)
@@ -206,12 +208,14 @@ static int _paste(void)
         return -1;
 
 #ifdef PDC_WIDE
+    PDC_STAT(allocs, 1);
     wpaste = malloc(len * sizeof(wchar_t));
     len = PDC_mbstowcs(wpaste, paste, len);
 #endif
     newmax = len + SP->c_ungind;
     if (newmax > SP->c_ungmax)
     {
+        PDC_STAT(allocs, 1);
         SP->c_ungch = realloc(SP->c_ungch, newmax * sizeof(int));
         if (!SP->c_ungch)
             return -1;
@@ -377,7 +381,7 @@ int wgetch(WINDOW *win)
     {
         /* is there a keystroke ready? */
 
-        if (!PDC_check_key())
+        if (!PDC_check_input())
         {
             /* if not, handle timeout() and halfdelay() */
 
@@ -398,7 +402,7 @@ int wgetch(WINDOW *win)
 
         /* if there is, fetch it */
 
-        key = PDC_get_key();
+        key = PDC_get_input();
 
         /* copy or paste? */
 
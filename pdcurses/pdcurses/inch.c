@@ -52,6 +52,8 @@ chtype winch(WINDOW *win)
     if (!win)
         return (chtype)ERR;
 
+    PDC_LAZY_RESOLVE(win, win->_cury);
+
     return win->_y[win->_cury][win->_curx];
 }
 
@@ -69,7 +71,7 @@ chtype mvinch(int y, int x)
     if (move(y, x) == ERR)
         return (chtype)ERR;
 
-    return stdscr->_y[stdscr->_cury][stdscr->_curx];
+    return winch(stdscr);
 }
 
 chtype mvwinch(WINDOW *win, int y, int x)
@@ -79,7 +81,7 @@ chtype mvwinch(WINDOW *win, int y, int x)
     if (wmove(win, y, x) == ERR)
         return (chtype)ERR;
 
-    return win->_y[win->_cury][win->_curx];
+    return winch(win);
 }
 
 #ifdef PDC_WIDE
@@ -90,6 +92,8 @@ int win_wch(WINDOW *win, cchar_t *wcval)
     if (!win || !wcval)
         return ERR;
 
+    PDC_LAZY_RESOLVE(win, win->_cury);
+
     *wcval = win->_y[win->_cury][win->_curx];
 
     return OK;
@@ -109,9 +113,7 @@ int mvin_wch(int y, int x, cchar_t *wcval)
     if (!wcval || (move(y, x) == ERR))
         return ERR;
 
-    *wcval = stdscr->_y[stdscr->_cury][stdscr->_curx];
-
-    return OK;
+    return win_wch(stdscr, wcval);
 }
 
 int mvwin_wch(WINDOW *win, int y, int x, cchar_t *wcval)
@@ -121,8 +123,6 @@ int mvwin_wch(WINDOW *win, int y, int x, cchar_t *wcval)
     if (!wcval || (wmove(win, y, x) == ERR))
         return ERR;
 
-    *wcval = win->_y[win->_cury][win->_curx];
-
-    return OK;
+    return win_wch(win, wcval);
 }
 #endif
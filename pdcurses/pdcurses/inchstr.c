@@ -73,6 +73,8 @@ int winchnstr(WINDOW *win, chtype *ch, int n)
     if ((win->_curx + n) > win->_maxx)
         n = win->_maxx - win->_curx;
 
+    PDC_LAZY_RESOLVE(win, win->_cury);
+
     src = win->_y[win->_cury] + win->_curx;
 
     for (i = 0; i < n; i++)
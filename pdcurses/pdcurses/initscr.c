@@ -127,6 +127,7 @@ WINDOW *initscr(void)
     if (SP && SP->alive)
         return NULL;
 
+    PDC_STAT(allocs, 1);
     SP = calloc(1, sizeof(SCREEN));
     if (!SP)
         return NULL;
@@ -155,6 +156,7 @@ WINDOW *initscr(void)
     SP->dbfp = NULL;
     SP->color_started = FALSE;
     SP->dirty = FALSE;
+    SP->suspended = FALSE;
     SP->sel_start = -1;
     SP->sel_end = -1;
 
@@ -228,6 +230,7 @@ WINDOW *initscr(void)
     else
         curscr->_clear = TRUE;
 
+    PDC_STAT(allocs, 1);
     SP->atrtab = calloc(PDC_COLOR_PAIRS, sizeof(PDC_PAIR));
     if (!SP->atrtab)
         return NULL;
@@ -245,18 +248,24 @@ WINDOW *initscr(void)
 
     sprintf(ttytype, "pdcurses|PDCurses for %s", PDC_sysname());
 
+    PDC_STAT(allocs, 1);
     SP->c_buffer = malloc(_INBUFSIZ * sizeof(int));
     if (!SP->c_buffer)
         return NULL;
     SP->c_pindex = 0;
     SP->c_gindex = 1;
 
+    PDC_STAT(allocs, 1);
     SP->c_ungch = malloc(NUNGETCH * sizeof(int));
     if (!SP->c_ungch)
         return NULL;
     SP->c_ungind = 0;
     SP->c_ungmax = NUNGETCH;
 
+    PDC_replay_init();
+    PDC_bench_init();
+    PDC_trace_init();
+
     return stdscr;
 }
 
@@ -278,6 +287,7 @@ int endwin(void)
 
     def_prog_mode();
     PDC_scr_close();
+    PDC_bench_report();
 
     SP->alive = FALSE;
 
@@ -330,9 +340,12 @@ void delscreen(SCREEN *sp)
     SP->alive = FALSE;
 
     PDC_scr_free();
+    PDC_printw_free();
 
     free(SP);
     SP = (SCREEN *)NULL;
+
+    PDC_pool_trim();
 }
 
 int resize_term(int nlines, int ncols)
@@ -152,6 +152,9 @@ int winsch(WINDOW *win, chtype ch)
         ch |= attr;
 
         maxx = win->_maxx;
+        PDC_LAZY_RESOLVE(win, y);
+        PDC_COW_WRITE(win, y);
+
         temp = &win->_y[y][x];
 
         memmove(temp + 1, temp, (maxx - x - 1) * sizeof(chtype));
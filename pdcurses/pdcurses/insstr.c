@@ -69,6 +69,100 @@ insstr
 
 #include <string.h>
 
+/* characters that winsch() would translate */
+
+#define _INS_XLAT(c) (!SP->raw_out && ((c) < ' ' || (c) == 0x7f))
+
+#ifdef PDC_WIDE
+typedef wchar_t _INSCHAR;
+#else
+typedef unsigned char _INSCHAR;
+#endif
+
+/* insert a run of characters that need no translation at the cursor,
+   with the same result as calling winsch() for each, from the last to
+   the first -- but with one shift of the rest of the line, one write,
+   and one update of the changed range, instead of one per character */
+
+static int _ins_run(WINDOW *win, const _INSCHAR *str, int n)
+{
+    int x = win->_curx, y = win->_cury, maxx = win->_maxx, i;
+    chtype attr, blank, *temp;
+
+    if (y >= win->_maxy || x >= maxx || y < 0 || x < 0)
+        return ERR;
+
+    /* characters pushed past the end of the line would be lost */
+
+    if (n > maxx - x)
+        n = maxx - x;
+
+    /* as in winsch(), for a character with no attributes */
+
+    attr = win->_attrs;
+
+    if (!(attr & A_COLOR))
+        attr |= win->_bkgd & A_ATTRIBUTES;
+    else
+        attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
+
+    blank = (win->_bkgd & A_CHARTEXT) | attr;
+    PDC_LAZY_RESOLVE(win, y);
+    PDC_COW_WRITE(win, y);
+
+    temp = win->_y[y] + x;
+
+    memmove(temp + n, temp, (maxx - x - n) * sizeof(chtype));
+
+    for (i = 0; i < n; i++)
+    {
+        chtype ch = (chtype)str[i];
+#ifdef PDC_WIDE
+        /* characters that don't fit in the chtype */
+
+        if (ch > A_CHARTEXT)
+            ch = 0xfffd;
+#endif
+        temp[i] = (ch == ' ') ? blank : (ch | attr);
+    }
+
+    win->_lastch[y] = maxx - 1;
+
+    if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
+        win->_firstch[y] = x;
+
+    PDC_sync(win);
+
+    return OK;
+}
+
+/* insert n characters at the cursor, working back from the end of the
+   string: runs of plain characters go in at once, and the characters
+   that need translation go through winsch() */
+
+static int _ins_str(WINDOW *win, const _INSCHAR *str, int n)
+{
+    int i;
+
+    while (n > 0)
+    {
+        for (i = n; i > 0 && !_INS_XLAT(str[i - 1]); i--)
+            ;
+
+        if (i < n)
+        {
+            if (_ins_run(win, str + i, n - i) == ERR)
+                return ERR;
+
+            n = i;
+        }
+        else if (winsch(win, str[--n]) == ERR)
+            return ERR;
+    }
+
+    return OK;
+}
+
 int winsnstr(WINDOW *win, const char *str, int n)
 {
 #ifdef PDC_WIDE
@@ -98,21 +192,23 @@ int winsnstr(WINDOW *win, const char *str, int n)
     {
         int retval = PDC_mbtowc(p, str + i, n - i);
 
-        if (retval <= 0)
+        if (!retval || (retval < 0 && n < len &&
+                        PDC_mbpartial(str + i, n - i)))
             break;
+
+        if (retval < 0)     /* not valid; see waddnstr() */
+        {
+            *p = 0xfffd;
+            retval = 1;
+        }
         p++;
         i += retval;
     }
 
-    while (p > wstr)
-        if (winsch(win, *--p) == ERR)
+    return _ins_str(win, wstr, (int)(p - wstr));
 #else
-    while (n)
-        if (winsch(win, (unsigned char)(str[--n])) == ERR)
+    return _ins_str(win, (const unsigned char *)str, n);
 #endif
-            return ERR;
-
-    return OK;
 }
 
 int insstr(const char *str)
@@ -195,11 +291,7 @@ int wins_nwstr(WINDOW *win, const wchar_t *wstr, int n)
     if (n < 0 || n > len)
         n = len;
 
-    while (n)
-        if (winsch(win, wstr[--n]) == ERR)
-            return ERR;
-
-    return OK;
+    return _ins_str(win, wstr, n);
 }
 
 int ins_wstr(const wchar_t *wstr)
@@ -88,6 +88,8 @@ int winnstr(WINDOW *win, char *str, int n)
     if (n < 0 || (win->_curx + n) > win->_maxx)
         n = win->_maxx - win->_curx;
 
+    PDC_LAZY_RESOLVE(win, win->_cury);
+
     src = win->_y[win->_cury] + win->_curx;
 
     for (i = 0; i < n; i++)
@@ -174,6 +176,8 @@ int winnwstr(WINDOW *win, wchar_t *wstr, int n)
     if (n < 0 || (win->_curx + n) > win->_maxx)
         n = win->_maxx - win->_curx;
 
+    PDC_LAZY_RESOLVE(win, win->_cury);
+
     src = win->_y[win->_cury] + win->_curx;
 
     for (i = 0; i < n; i++)
@@ -243,13 +243,15 @@ int napms(int ms)
 
         leaveok(curscr, TRUE);
 
-        wrefresh(curscr);
+        /* init_color() has marked the cells to be drawn again */
+
+        doupdate();
 
         leaveok(curscr, leave_state);
         curs_set(curs_state);
     }
 
-    if (ms)
+    if (ms && PDC_advance_clock(ms))
         PDC_napms(ms);
 
     return OK;
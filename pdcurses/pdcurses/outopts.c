@@ -20,6 +20,7 @@ outopts
     int scrollok(WINDOW *win, bool bf);
 
     int raw_output(bool bf);
+    int wsetstatic(WINDOW *win, bool bf);
 
     bool is_cleared(const WINDOW *win);
     bool is_idlok(const WINDOW *win);
@@ -27,6 +28,7 @@ outopts
     bool is_immedok(const WINDOW *win);
     bool is_leaveok(const WINDOW *win);
     bool is_scrollok(const WINDOW *win);
+    bool is_static(const WINDOW *win);
 
 ### Description
 
@@ -58,6 +60,15 @@ outopts
    *add* and *ins* curses functions (that is, it disables translation of
    control characters).
 
+   wsetstatic(), with bf TRUE, tells the panel functions that a window
+   is drawn once and then seldom changes -- a frame, a background, a help
+   panel. Normally, every panel is copied to the screen again whenever
+   the deck is changed; a static one is copied again only where it's
+   been written to, or where a panel that covered it has moved, been
+   hidden or changed, or when it's itself moved, raised or lowered. So a
+   complex layout of static panels costs little to rearrange.
+   is_static() reports whether the window is static.
+
    is_cleared() reports whether the specified window causes clear at next
    refresh.
 
@@ -69,10 +80,11 @@ outopts
 
 ### Return Value
 
-   is_cleared(), is_immedok(), is_leaveok() and is_scrollok() return TRUE
-   or FALSE. is_idlok() and is_idcok() are provided for compatibility with
-   other curses implementations, and always return FALSE. All others
-   return OK on success and ERR on error.
+   is_cleared(), is_immedok(), is_leaveok(), is_scrollok() and
+   is_static() return TRUE or FALSE. is_idlok() and is_idcok() are
+   provided for compatibility with other curses implementations, and
+   always return FALSE. All others return OK on success and ERR on
+   error.
 
 ### Portability
 
@@ -94,6 +106,8 @@ outopts
    is_leaveok            |    -   |    Y    |   Y
    is_scrollok           |    -   |    Y    |   -
    raw_output            |    -   |    -    |   -
+   wsetstatic            |    -   |    -    |   -
+   is_static             |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -260,3 +274,28 @@ bool is_scrollok(const WINDOW *win)
 
     return win->_scroll;
 }
+
+int wsetstatic(WINDOW *win, bool bf)
+{
+    PDC_LOG(("wsetstatic() - called\n"));
+
+    if (!win)
+        return ERR;
+
+    if (bf)
+        win->_flags |= _STATIC;
+    else
+        win->_flags &= ~_STATIC;
+
+    return OK;
+}
+
+bool is_static(const WINDOW *win)
+{
+    PDC_LOG(("is_static() - called\n"));
+
+    if (!win)
+        return FALSE;
+
+    return !!(win->_flags & _STATIC);
+}
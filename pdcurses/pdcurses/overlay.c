@@ -48,23 +48,121 @@ overlay
 
 **man-end****************************************************************/
 
+#include <string.h>
+
 /* Thanks to Andreas Otte <venn@@uni-paderborn.de> for the
    corrected overlay()/overwrite() behavior. */
 
+/* Copy n cells from src to dst -- for an overlay, only those whose
+   character isn't a blank. Returns the index of the first cell that
+   changed, or _NO_CHANGE, and sets *last to the index of the last.
+   Where the target has vectors, four cells at a time are compared and
+   blended through a mask of the cells to keep; for an overwrite, the
+   blank test is made against a value that can't match. */
+
+#if defined(PDC_SSE2) || defined(PDC_WASM_SIMD)
+static const signed char _lowbit[16] = {0, 0, 1, 0, 2, 0, 1, 0,
+                                        3, 0, 1, 0, 2, 0, 1, 0};
+static const signed char _highbit[16] = {0, 0, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 3, 3, 3, 3};
+#endif
+
+static int _copy_line(chtype *dst, const chtype *src, int n, bool blend,
+                      int *last)
+{
+    int i = 0, first = _NO_CHANGE;
+
+    /* if dst overlaps src from above, only the one-at-a-time loop
+       gives the same result as before */
+
+    bool simd = sizeof(chtype) == 4 && (dst <= src || dst >= src + n);
+
+#if defined(PDC_SSE2)
+    if (simd)
+    {
+        __m128i text = _mm_set1_epi32((int)A_CHARTEXT);
+        __m128i blank = _mm_set1_epi32(blend ? ' ' : -1);
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+            __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+            __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(s, d),
+                _mm_cmpeq_epi32(_mm_and_si128(s, text), blank));
+            int mask = ~_mm_movemask_ps(_mm_castsi128_ps(keep)) & 0xf;
+
+            if (mask)
+            {
+                _mm_storeu_si128((__m128i *)(dst + i),
+                    _mm_or_si128(_mm_and_si128(keep, d),
+                                 _mm_andnot_si128(keep, s)));
+
+                if (first == _NO_CHANGE)
+                    first = i + _lowbit[mask];
+                *last = i + _highbit[mask];
+            }
+        }
+    }
+#elif defined(PDC_WASM_SIMD)
+    if (simd)
+    {
+        v128_t text = wasm_i32x4_splat((int)A_CHARTEXT);
+        v128_t blank = wasm_i32x4_splat(blend ? ' ' : -1);
+
+        for (; i + 4 <= n; i += 4)
+        {
+            v128_t s = wasm_v128_load(src + i);
+            v128_t d = wasm_v128_load(dst + i);
+            v128_t keep = wasm_v128_or(wasm_i32x4_eq(s, d),
+                wasm_i32x4_eq(wasm_v128_and(s, text), blank));
+            int mask = ~wasm_i32x4_bitmask(keep) & 0xf;
+
+            if (mask)
+            {
+                wasm_v128_store(dst + i, wasm_v128_bitselect(d, s, keep));
+
+                if (first == _NO_CHANGE)
+                    first = i + _lowbit[mask];
+                *last = i + _highbit[mask];
+            }
+        }
+    }
+#else
+    (void)simd;
+#endif
+    for (; i < n; i++)
+    {
+        if (src[i] != dst[i] && !((src[i] & A_CHARTEXT) == ' ' && blend))
+        {
+            dst[i] = src[i];
+
+            if (first == _NO_CHANGE)
+                first = i;
+            *last = i;
+        }
+    }
+
+    return first;
+}
+
 static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
                      int src_tc, int src_br, int src_bc, int dst_tr,
                      int dst_tc, bool _overlay)
 {
-    int col, line, y1, fc, *minchng, *maxchng;
-    chtype *w1ptr, *w2ptr;
+    int line, y1, fc, lc, *minchng, *maxchng;
 
-    int lc = 0;
     int xdiff = src_bc - src_tc;
     int ydiff = src_br - src_tr;
 
     if (!src_w || !dst_w)
         return ERR;
 
+    if (xdiff <= 0 || ydiff <= 0)
+        return OK;
+
+    PDC_LAZY_FLUSH((WINDOW *)src_w);
+    PDC_LAZY_FLUSH(dst_w);
+
     minchng = dst_w->_firstch;
     maxchng = dst_w->_lastch;
 
@@ -76,39 +174,42 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
 
     for (line = 0; line < ydiff; line++)
     {
-        w1ptr = src_w->_y[line + src_tr] + src_tc;
-        w2ptr = dst_w->_y[line + dst_tr] + dst_tc;
-
-        fc = _NO_CHANGE;
+        /* keep a line that's shared, or a paged pad's blank line, if
+           there's nothing to copy into it */
 
-        for (col = 0; col < xdiff; col++)
+        if (dst_w->_cow && !_overlay &&
+            !memcmp(dst_w->_y[line + dst_tr] + dst_tc,
+                    src_w->_y[line + src_tr] + src_tc,
+                    xdiff * sizeof(chtype)))
         {
-            if ((*w1ptr) != (*w2ptr) &&
-                !((*w1ptr & A_CHARTEXT) == ' ' && _overlay))
-            {
-                *w2ptr = *w1ptr;
-
-                if (fc == _NO_CHANGE)
-                    fc = col + dst_tc;
+            minchng++;
+            maxchng++;
+            continue;
+        }
 
-                lc = col + dst_tc;
-            }
+        PDC_COW_WRITE(dst_w, line + dst_tr);
 
-            w1ptr++;
-            w2ptr++;
-        }
+        fc = _copy_line(dst_w->_y[line + dst_tr] + dst_tc,
+                        src_w->_y[line + src_tr] + src_tc, xdiff,
+                        _overlay, &lc);
 
-        if (*minchng == _NO_CHANGE)
-        {
-            *minchng = fc;
-            *maxchng = lc;
-        }
-        else if (fc != _NO_CHANGE)
+        if (fc != _NO_CHANGE)
         {
-            if (fc < *minchng)
+            fc += dst_tc;
+            lc += dst_tc;
+
+            if (*minchng == _NO_CHANGE)
+            {
                 *minchng = fc;
-            if (lc > *maxchng)
                 *maxchng = lc;
+            }
+            else
+            {
+                if (fc < *minchng)
+                    *minchng = fc;
+                if (lc > *maxchng)
+                    *maxchng = lc;
+            }
         }
 
         minchng++;
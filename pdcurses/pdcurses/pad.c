@@ -21,6 +21,8 @@ pad
 
     bool is_pad(const WINDOW *pad);
 
+    WINDOW *PDC_newpad_paged(int nlines, int ncols);
+
 ### Description
 
    A pad is a special kind of window, which is not restricted by the
@@ -42,7 +44,12 @@ pad
    When using sub-pads, you may need to call touchwin() before calling
    prefresh().
 
-   pnoutrefresh() copies the specified pad to the virtual screen.
+   pnoutrefresh() copies the specified pad to the virtual screen --
+   only the cells that differ from what's there. If the pad was last
+   shown in the same place, and only py differs, by less than the
+   number of lines shown, the lines still in view are first moved on
+   the virtual screen, so that mostly those coming into view are
+   copied.
 
    prefresh() calls pnoutrefresh(), followed by doupdate().
 
@@ -57,9 +64,21 @@ pad
 
    is_pad() reports whether the specified window is a pad.
 
+   PDC_newpad_paged() creates a pad like newpad(), but one whose memory
+   grows with what's written to it, rather than with its size -- for a
+   scrollback buffer of a million lines, say. Lines that have never been
+   written to share a single blank line; a line gets storage of its own
+   when first written, and gives it back when cleared to a blank
+   background with wclrtobot(), werase() or wclear(). The pad can be
+   used like any other. Changing its background with wbkgd(), or making
+   a copy of it with dupwin(), gives every line storage of its own; and
+   once a subpad has been made, cleared lines are no longer given back.
+
 ### Return Value
 
-   All functions except is_pad() return OK on success and ERR on error.
+   newpad(), subpad() and PDC_newpad_paged() return a pointer to the
+   new pad, or NULL on error. is_pad() returns TRUE or FALSE. The other
+   functions return OK on success and ERR on error.
 
 ### Portability
 
@@ -72,20 +91,20 @@ pad
    pechochar             |    Y   |    Y    |   Y
    pecho_wchar           |    Y   |    Y    |   Y
    is_pad                |    -   |    Y    |   Y
+   PDC_newpad_paged      |    -   |    -    |   -
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
-WINDOW *newpad(int nlines, int ncols)
+static WINDOW *_newpad(int nlines, int ncols, bool paged)
 {
     WINDOW *win;
 
-    PDC_LOG(("newpad() - called: lines=%d cols=%d\n", nlines, ncols));
-
     win = PDC_makenew(nlines, ncols, 0, 0);
     if (win)
-        win = PDC_makelines(win);
+        win = paged ? PDC_makepages(win) : PDC_makelines(win);
 
     if (!win)
         return (WINDOW *)NULL;
@@ -103,6 +122,13 @@ WINDOW *newpad(int nlines, int ncols)
     return win;
 }
 
+WINDOW *newpad(int nlines, int ncols)
+{
+    PDC_LOG(("newpad() - called: lines=%d cols=%d\n", nlines, ncols));
+
+    return _newpad(nlines, ncols, FALSE);
+}
+
 WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
 {
     WINDOW *win;
@@ -111,7 +137,9 @@ WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     PDC_LOG(("subpad() - called: lines=%d cols=%d begy=%d begx=%d\n",
              nlines, ncols, begy, begx));
 
-    if (!orig || !(orig->_flags & _PAD))
+    /* a provider pad's lines move as it's shown */
+
+    if (!orig || !(orig->_flags & _PAD) || orig->_provider)
         return (WINDOW *)NULL;
 
     /* make sure window fits inside the original one */
@@ -127,6 +155,9 @@ WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     if (!ncols)
         ncols = orig->_maxx - begx;
 
+    if (orig->_cow)
+        PDC_cow_own(orig, begy, nlines);
+
     win = PDC_makenew(nlines, ncols, begy, begx);
     if (!win)
         return (WINDOW *)NULL;
@@ -165,11 +196,102 @@ int prefresh(WINDOW *win, int py, int px, int sy1, int sx1, int sy2, int sx2)
     return OK;
 }
 
+/* copy num_cols columns of line pline of the pad, from column px, to
+   line sline of curscr, from column sx1 -- only the span of them that
+   differs from what curscr holds. Returns the number of cells copied. */
+
+static long _copy_line(WINDOW *w, int pline, int sline, int px, int sx1,
+                       int num_cols)
+{
+    const chtype *src = w->_y[pline] + px;
+    chtype *dst = curscr->_y[sline] + sx1;
+    int first = 0, last = num_cols - 1;
+
+    if (!memcmp(dst, src, num_cols * sizeof(chtype)))
+        return 0;
+
+    while (src[first] == dst[first])
+        first++;
+
+    while (src[last] == dst[last])
+        last--;
+
+    PDC_COW_WRITE(curscr, sline);
+
+    memcpy(curscr->_y[sline] + sx1 + first, src + first,
+           (last - first + 1) * sizeof(chtype));
+
+    if ((curscr->_firstch[sline] == _NO_CHANGE)
+        || (curscr->_firstch[sline] > sx1 + first))
+        curscr->_firstch[sline] = sx1 + first;
+
+    if (sx1 + last > curscr->_lastch[sline])
+        curscr->_lastch[sline] = sx1 + last;
+
+    return last - first + 1;
+}
+
+/* move columns sx1 to sx2 of lines start to end of curscr n lines up
+   (or down, if n is negative), as the pad shown there has scrolled by
+   n lines. Where the pad spans the screen, the line pointers are
+   rotated, as in wscrl(). The lines left at the other end are
+   refilled by the caller, which copies only what differs from them,
+   so they're marked as changed too. */
+
+static void _shift_lines(int start, int end, int sx1, int sx2, int n)
+{
+    int i, y, dir = (n > 0) ? 1 : -1;
+    chtype *temp;
+
+    if (n < 0)
+    {
+        y = start;
+        start = end;
+        end = y;
+    }
+
+    if (!sx1 && sx2 == curscr->_maxx - 1)
+    {
+        for (i = 0; i < n * dir; i++)
+        {
+            PDC_COW_ROTATE(curscr, start, end, dir);
+
+            temp = curscr->_y[start];
+
+            for (y = start; y != end; y += dir)
+                curscr->_y[y] = curscr->_y[y + dir];
+
+            curscr->_y[end] = temp;
+        }
+    }
+    else
+        for (y = start; y != end - n + dir; y += dir)
+        {
+            PDC_COW_WRITE(curscr, y);
+
+            memcpy(curscr->_y[y] + sx1, curscr->_y[y + n] + sx1,
+                   (sx2 - sx1 + 1) * sizeof(chtype));
+        }
+
+    for (y = start; y != end + dir; y += dir)
+    {
+        if ((curscr->_firstch[y] == _NO_CHANGE)
+            || (curscr->_firstch[y] > sx1))
+            curscr->_firstch[y] = sx1;
+
+        if (sx2 > curscr->_lastch[y])
+            curscr->_lastch[y] = sx2;
+    }
+}
+
 int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
 {
     int num_cols;
     int sline;
     int pline;
+    int top;
+    int rows;
+    long cells = 0;
 
     PDC_LOG(("pnoutrefresh() - called\n"));
 
@@ -187,33 +309,47 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
         (sy2 < sy1) || (sx2 < sx1))
         return ERR;
 
-    sline = sy1;
-    pline = py;
+    top = py;
 
-    num_cols = min((sx2 - sx1 + 1), (w->_maxx - px));
+    /* a provider pad holds just the lines in view, from its first line */
 
-    while (sline <= sy2)
+    if (w->_provider)
     {
-        if (pline < w->_maxy)
-        {
-            memcpy(curscr->_y[sline] + sx1, w->_y[pline] + px,
-                   num_cols * sizeof(chtype));
+        if (PDC_provider_show(w, py, sy2 - sy1 + 1) == ERR)
+            return ERR;
 
-            if ((curscr->_firstch[sline] == _NO_CHANGE)
-                || (curscr->_firstch[sline] > sx1))
-                curscr->_firstch[sline] = sx1;
+        top = 0;
+    }
 
-            if (sx2 > curscr->_lastch[sline])
-                curscr->_lastch[sline] = sx2;
+    PDC_BENCH_BEGIN(PDC_STAGE_WNOUTREFRESH);
 
-            w->_firstch[pline] = _NO_CHANGE; /* updated now */
-            w->_lastch[pline] = _NO_CHANGE;  /* updated now */
-        }
+    num_cols = min((sx2 - sx1 + 1), (w->_maxx - px));
+    rows = min((sy2 - sy1 + 1), (w->_maxy - top));
+
+    /* If the pad was last shown in the same place on the screen, and
+       it's been scrolled by n lines, fewer than are shown, the lines
+       still in view are first moved by n in curscr. Then each line is
+       compared with curscr, and only what differs is copied -- what's
+       changed in the pad, what's come into view, and anything drawn
+       over the pad since. */
+
+    if (!w->_clear && sy1 == w->_pad._pad_top && sx1 == w->_pad._pad_left
+        && sy2 == w->_pad._pad_bottom && sx2 == w->_pad._pad_right
+        && px == w->_pad._pad_x && py != w->_pad._pad_y
+        && abs(py - w->_pad._pad_y) < rows && num_cols > 0)
+        _shift_lines(sy1, sy1 + rows - 1, sx1, sx1 + num_cols - 1,
+                     py - w->_pad._pad_y);
+
+    for (sline = sy1, pline = top; sline < sy1 + rows; sline++, pline++)
+    {
+        PDC_LAZY_RESOLVE(w, pline);
 
-        sline++;
-        pline++;
-    }
+        if (num_cols > 0)
+            cells += _copy_line(w, pline, sline, px, sx1, num_cols);
 
+        w->_firstch[pline] = _NO_CHANGE; /* updated now */
+        w->_lastch[pline] = _NO_CHANGE;  /* updated now */
+    }
     if (w->_clear)
     {
         w->_clear = FALSE;
@@ -224,10 +360,10 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
        is the pad current position going to end up displayed? if not,
        then don't move the cursor; if so, move it to the correct place */
 
-    if (!w->_leaveit && w->_cury >= py && w->_curx >= px &&
-         w->_cury <= py + (sy2 - sy1) && w->_curx <= px + (sx2 - sx1))
+    if (!w->_leaveit && w->_cury >= top && w->_curx >= px &&
+         w->_cury <= top + (sy2 - sy1) && w->_curx <= px + (sx2 - sx1))
     {
-        curscr->_cury = (w->_cury - py) + sy1;
+        curscr->_cury = (w->_cury - top) + sy1;
         curscr->_curx = (w->_curx - px) + sx1;
     }
 
@@ -238,9 +374,13 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
     w->_pad._pad_bottom = sy2;
     w->_pad._pad_right = sx2;
 
+    PDC_STAT(cells_copied, cells);
+    PDC_BENCH_END(PDC_STAGE_WNOUTREFRESH, cells);
+
     return OK;
 }
 
+
 int pechochar(WINDOW *pad, chtype ch)
 {
     PDC_LOG(("pechochar() - called\n"));
@@ -274,3 +414,163 @@ bool is_pad(const WINDOW *pad)
 
     return (pad->_flags & _PAD) ? TRUE : FALSE;
 }
+
+WINDOW *PDC_newpad_paged(int nlines, int ncols)
+{
+    PDC_LOG(("PDC_newpad_paged() - called: lines=%d cols=%d\n",
+             nlines, ncols));
+
+    return _newpad(nlines, ncols, TRUE);
+}
+
+/* give a new window the shared blank line, in place of PDC_makelines() */
+
+WINDOW *PDC_makepages(WINDOW *win)
+{
+    struct _pdc_cow *cow;
+    struct _pdc_pages *pages;
+    int i;
+
+    if (!win)
+        return (WINDOW *)NULL;
+
+    cow = calloc(1, sizeof(struct _pdc_cow));
+    pages = calloc(1, sizeof(struct _pdc_pages));
+    if (pages)
+        pages->zero = malloc(win->_maxx * sizeof(chtype));
+
+    if (!cow || !pages || !pages->zero)
+    {
+        if (pages)
+            free(pages->zero);
+
+        free(pages);
+        free(cow);
+        PDC_freewin(win);
+
+        return (WINDOW *)NULL;
+    }
+
+    PDC_STAT(allocs, 3);
+
+    pages->blank = win->_bkgd;
+    PDC_fill(pages->zero, pages->blank, win->_maxx);
+
+    cow->pages = pages;
+    win->_cow = cow;
+
+    for (i = 0; i < win->_maxy; i++)
+        win->_y[i] = pages->zero;
+
+    return win;
+}
+
+/* before line y of a paged pad is written to, give it a line of its
+   own, if it hasn't one already */
+
+void PDC_page_write(WINDOW *win, int y)
+{
+    struct _pdc_pages *pages = win->_cow->pages;
+    size_t size = win->_maxx * sizeof(chtype);
+    chtype *line, **tmp;
+    int newmax;
+
+    if (win->_y[y] != pages->zero)
+        return;
+
+    if (pages->nspare)
+        line = pages->spare[--pages->nspare];
+    else
+    {
+        if (!pages->npages || pages->used == PDC_PAGE_LINES)
+        {
+            /* as with PDC_cow_write(), if there's no memory, the write
+               will be seen by the other blank lines */
+
+            if (pages->npages == pages->maxpages)
+            {
+                newmax = pages->maxpages ? pages->maxpages * 2 : 16;
+                tmp = realloc(pages->page, newmax * sizeof(chtype *));
+                if (!tmp)
+                    return;
+
+                PDC_STAT(allocs, 1);
+
+                pages->page = tmp;
+                pages->maxpages = newmax;
+            }
+
+            line = malloc(PDC_PAGE_LINES * size);
+            if (!line)
+                return;
+
+            PDC_STAT(allocs, 1);
+
+            pages->page[pages->npages++] = line;
+            pages->used = 0;
+        }
+
+        line = pages->page[pages->npages - 1] +
+               pages->used++ * win->_maxx;
+    }
+
+    memcpy(line, pages->zero, size);
+    win->_y[y] = line;
+}
+
+/* line y of a paged pad is to be cleared to the background: if that's
+   what the shared blank line holds, point it there instead, keeping
+   its line for reuse, and return TRUE */
+
+bool PDC_page_clear(WINDOW *win, int y)
+{
+    struct _pdc_pages *pages = win->_cow->pages;
+    chtype **tmp;
+    int newmax;
+
+    if (pages->pinned || win->_bkgd != pages->blank)
+        return FALSE;
+
+    if (win->_y[y] != pages->zero)
+    {
+        if (pages->nspare == pages->maxspare)
+        {
+            newmax = pages->maxspare ? pages->maxspare * 2 : 64;
+            tmp = realloc(pages->spare, newmax * sizeof(chtype *));
+            if (!tmp)
+                return FALSE;
+
+            PDC_STAT(allocs, 1);
+
+            pages->spare = tmp;
+            pages->maxspare = newmax;
+        }
+
+        pages->spare[pages->nspare++] = win->_y[y];
+        win->_y[y] = pages->zero;
+    }
+
+    return TRUE;
+}
+
+/* free the lines of a paged pad, and set them to NULL in win */
+
+void PDC_page_free(WINDOW *win)
+{
+    struct _pdc_pages *pages = win->_cow->pages;
+    int i;
+
+    for (i = 0; i < pages->npages; i++)
+        free(pages->page[i]);
+
+    for (i = 0; i < win->_maxy; i++)
+        win->_y[i] = NULL;
+
+    free(pages->page);
+    free(pages->spare);
+    free(pages->zero);
+    free(pages);
+    free(win->_cow);
+
+    win->_cow = NULL;
+}
@@ -239,8 +239,16 @@ static void _override(PANEL *pan, int show)
         Touchpan(pan);
     else if (!show)
     {
+        int y = max(pan->wstarty, 0);
+        int end = min(pan->wendy, _stdscr_pseudo_panel.win->_maxy);
+
+        /* only the lines of stdscr that the panel covered need to be
+           copied again, along with those of the panels they cross */
+
         Touchpan(pan);
-        Touchpan(&_stdscr_pseudo_panel);
+
+        if (y < end)
+            Touchline(&_stdscr_pseudo_panel, y, end - y);
     }
     else if (show == -1)
         while (tobs && (tobs->pan != pan))
@@ -276,6 +284,7 @@ static void _calculate_obscure(void)
         {
             if (_panels_overlapped(pan, pan2))
             {
+                PDC_STAT(allocs, 1);
                 if ((tobs = malloc(sizeof(PANELOBS))) == NULL)
                     return;
 
@@ -294,7 +303,12 @@ static void _calculate_obscure(void)
             pan2 = pan2->above;
         }
 
-        _override(pan, 1);
+        /* a static panel is on the screen already; it's copied again
+           only where it's touched */
+
+        if (!(pan->win->_flags & _STATIC))
+            _override(pan, 1);
+
         pan = pan->above;
     }
 }
@@ -339,6 +353,7 @@ static void _panel_link_top(PANEL *pan)
     if (!_bottom_panel)
         _bottom_panel = pan;
 
+    Touchpan(pan);
     _calculate_obscure();
     dStack("<lt%d>", 9, pan);
 }
@@ -366,11 +381,16 @@ static void _panel_link_bottom(PANEL *pan)
     if (!_top_panel)
         _top_panel = pan;
 
+    Touchpan(pan);
     _calculate_obscure();
     dStack("<lb%d>", 9, pan);
 }
 
-static void _panel_unlink(PANEL *pan)
+/* take a panel out of the stack; if it's to be put back in at once, at
+   the top or bottom, it still covers the same part of the screen, so
+   what's under it needn't be touched */
+
+static void _panel_unlink(PANEL *pan, bool restack)
 {
     PANEL *prev;
     PANEL *next;
@@ -380,7 +400,9 @@ static void _panel_unlink(PANEL *pan)
     if (!_panel_is_linked(pan))
         return;
 #endif
-    _override(pan, 0);
+    if (!restack)
+        _override(pan, 0);
+
     _free_obscure(pan);
 
     prev = pan->below;
@@ -424,7 +446,7 @@ int bottom_panel(PANEL *pan)
         return OK;
 
     if (_panel_is_linked(pan))
-        hide_panel(pan);
+        _panel_unlink(pan, TRUE);
 
     _panel_link_bottom(pan);
 
@@ -457,7 +479,7 @@ int hide_panel(PANEL *pan)
         return ERR;
     }
 
-    _panel_unlink(pan);
+    _panel_unlink(pan, FALSE);
 
     return OK;
 }
@@ -484,7 +506,10 @@ int move_panel(PANEL *pan, int starty, int startx)
     pan->wendx = pan->wstartx + maxx;
 
     if (_panel_is_linked(pan))
+    {
+        Touchpan(pan);
         _calculate_obscure();
+    }
 
     return OK;
 }
@@ -496,6 +521,7 @@ PANEL *new_panel(WINDOW *win)
     if (!win)
         return (PANEL *)NULL;
 
+    PDC_STAT(allocs, 1);
     pan  = malloc(sizeof(PANEL));
 
     if (!_stdscr_pseudo_panel.win)
@@ -582,7 +608,10 @@ int replace_panel(PANEL *pan, WINDOW *win)
     pan->wendx = pan->wstartx + maxx;
 
     if (_panel_is_linked(pan))
+    {
+        Touchpan(pan);
         _calculate_obscure();
+    }
 
     return OK;
 }
@@ -605,7 +634,7 @@ int show_panel(PANEL *pan)
         return OK;
 
     if (_panel_is_linked(pan))
-        hide_panel(pan);
+        _panel_unlink(pan, TRUE);
 
     _panel_link_top(pan);
 
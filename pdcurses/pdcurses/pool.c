@@ -0,0 +1,273 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+pool
+----
+
+### Synopsis
+
+    int PDC_arena_begin(void);
+    int PDC_arena_end(void);
+    void PDC_pool_trim(void);
+
+### Description
+
+   Windows and their lines are allocated from pools, kept by size, so
+   that making and deleting windows of the same sizes over and over --
+   popups, tooltips and menus, say -- reuses the same memory, instead of
+   calling malloc() and free() each time. The memory given back by
+   delwin() is kept for reuse, up to PDC_POOL_MAX bytes in all (4 MB,
+   unless PDCurses is built with it defined otherwise); beyond that,
+   it's freed.
+
+   PDC_arena_begin() starts a scope for windows. Every window made after
+   it, until the matching PDC_arena_end() -- including subwindows, pads,
+   and copies made by dupwin() -- belongs to the scope, and is deleted
+   by PDC_arena_end(), if it hasn't been deleted already. They're
+   deleted in the reverse of the order they were made in, so subwindows
+   go before their parents. Scopes can be nested; a window made in an
+   inner one belongs only to that. Deleting a window in a scope with
+   delwin(), before the end of it, is still allowed.
+
+   PDC_pool_trim() frees the memory kept in the pools. delscreen() calls
+   it.
+
+### Return Value
+
+   PDC_arena_begin() returns OK, or ERR if there's no memory for the
+   scope. PDC_arena_end() returns OK, or ERR if no scope was begun.
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_arena_begin       |    -   |    -    |   -
+   PDC_arena_end         |    -   |    -    |   -
+   PDC_pool_trim         |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+
+#ifndef PDC_POOL_MAX
+# define PDC_POOL_MAX (4L * 1024 * 1024)
+#endif
+
+/* Each block starts with a header giving its size class, so that it can
+   be given back without its size. The classes go up in half steps --
+   16, 24, 32, 48, 64 bytes and so on, to 24 KB -- so no more than a
+   third of a block is wasted. Bigger blocks come from malloc() and go
+   back to free(). A block in a pool is linked to the next one through
+   its first bytes. */
+
+#define _NCLASSES 22
+
+typedef union
+{
+    int cls;            /* size class, or -1 if not pooled */
+    void *p;            /* (to keep what follows aligned) */
+    double d;
+    long l;
+} PDC_BLOCK;
+
+static PDC_BLOCK *pool[_NCLASSES];
+static long pool_bytes = 0;         /* kept in all the pools */
+
+/* windows made in scopes, and where each scope starts among them */
+
+static WINDOW **arena = NULL;
+static int narena = 0, maxarena = 0;
+static int *scope = NULL;
+static int nscope = 0, maxscope = 0;
+
+static size_t _class_size(int cls)
+{
+    return (size_t)((cls & 1) ? 24 : 16) << (cls >> 1);
+}
+
+static int _class(size_t size)
+{
+    int cls;
+
+    for (cls = 0; cls < _NCLASSES; cls++)
+        if (_class_size(cls) >= size)
+            return cls;
+
+    return -1;
+}
+
+void *PDC_pool_alloc(size_t size)
+{
+    PDC_BLOCK *block;
+    int cls = _class(size);
+
+    if (cls >= 0 && pool[cls])
+    {
+        block = pool[cls];
+        pool[cls] = *(PDC_BLOCK **)(block + 1);
+        pool_bytes -= (long)_class_size(cls);
+    }
+    else
+    {
+        block = malloc(sizeof(PDC_BLOCK) +
+                       (cls >= 0 ? _class_size(cls) : size));
+        if (!block)
+            return NULL;
+
+        PDC_STAT(allocs, 1);
+    }
+
+    block->cls = cls;
+
+    return block + 1;
+}
+
+void PDC_pool_free(void *ptr)
+{
+    PDC_BLOCK *block;
+    int cls;
+
+    if (!ptr)
+        return;
+
+    block = (PDC_BLOCK *)ptr - 1;
+    cls = block->cls;
+
+    if (cls < 0 || pool_bytes + (long)_class_size(cls) > PDC_POOL_MAX)
+    {
+        free(block);
+        return;
+    }
+
+    *(PDC_BLOCK **)ptr = pool[cls];
+    pool[cls] = block;
+    pool_bytes += (long)_class_size(cls);
+}
+
+/* the usable size of a block, which may be more than was asked for; 0
+   if it's not known */
+
+size_t PDC_pool_size(const void *ptr)
+{
+    int cls = ((const PDC_BLOCK *)ptr - 1)->cls;
+
+    return (cls >= 0) ? _class_size(cls) : 0;
+}
+
+void PDC_pool_trim(void)
+{
+    PDC_BLOCK *block;
+    int cls;
+
+    PDC_LOG(("PDC_pool_trim() - called\n"));
+
+    for (cls = 0; cls < _NCLASSES; cls++)
+        while (pool[cls])
+        {
+            block = pool[cls];
+            pool[cls] = *(PDC_BLOCK **)(block + 1);
+            free(block);
+        }
+
+    pool_bytes = 0;
+
+    if (!nscope)
+    {
+        free(arena);
+        free(scope);
+        arena = NULL;
+        scope = NULL;
+        narena = maxarena = maxscope = 0;
+    }
+}
+
+int PDC_arena_begin(void)
+{
+    int *tmp;
+
+    PDC_LOG(("PDC_arena_begin() - called\n"));
+
+    if (nscope == maxscope)
+    {
+        tmp = realloc(scope, (maxscope + 8) * sizeof(int));
+        if (!tmp)
+            return ERR;
+
+        PDC_STAT(allocs, 1);
+
+        scope = tmp;
+        maxscope += 8;
+    }
+
+    scope[nscope++] = narena;
+
+    return OK;
+}
+
+int PDC_arena_end(void)
+{
+    WINDOW *win;
+
+    PDC_LOG(("PDC_arena_end() - called\n"));
+
+    if (!nscope)
+        return ERR;
+
+    nscope--;
+
+    /* each window is taken off the list before it's deleted, so that
+       delwin() doesn't look for it */
+
+    while (narena > scope[nscope])
+    {
+        win = arena[--narena];
+        if (win)
+            delwin(win);
+    }
+
+    return OK;
+}
+
+/* add a new window to the innermost scope, if there is one */
+
+bool PDC_arena_add(WINDOW *win)
+{
+    WINDOW **tmp;
+
+    if (!nscope)
+        return TRUE;
+
+    if (narena == maxarena)
+    {
+        tmp = realloc(arena, (maxarena ? maxarena * 2 : 32) *
+                             sizeof(WINDOW *));
+        if (!tmp)
+            return FALSE;
+
+        PDC_STAT(allocs, 1);
+
+        arena = tmp;
+        maxarena = maxarena ? maxarena * 2 : 32;
+    }
+
+    arena[narena++] = win;
+
+    return TRUE;
+}
+
+/* take a window that's going away out of its scope */
+
+void PDC_arena_forget(WINDOW *win)
+{
+    int i;
+
+    for (i = narena - 1; i >= 0; i--)
+        if (arena[i] == win)
+        {
+            arena[i] = NULL;
+            break;
+        }
+}
@@ -26,6 +26,12 @@ printw
    The duplication between vwprintw() and vw_printw() is for historic
    reasons. In PDCurses, they're the same.
 
+   Where the compiler provides vsnprintf(), there's no limit on the
+   length of the output: short strings are formatted on the stack, and
+   longer ones in a heap buffer that's kept for the next call, growing
+   as needed, until delscreen(). Otherwise, the output must fit in 512
+   bytes.
+
 ### Return Value
 
    All functions return the number of characters printed, or ERR on
@@ -44,21 +50,99 @@ printw
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
+#ifndef va_copy
+# ifdef __va_copy
+#  define va_copy(dest, src) __va_copy(dest, src)
+# else
+#  define va_copy(dest, src) memcpy(&(dest), &(src), sizeof(va_list))
+# endif
+#endif
+
+#define _PRINTW_MAXGROW 0x100000L   /* give up doubling the buffer here */
+
+/* The buffer for output that doesn't fit on the stack. It's kept, and
+   grown as needed, until delscreen(); while the output is long, it's
+   tried first, so that each call formats it only once. */
+
+static char *printw_buf = NULL;
+static size_t printw_size = 0;
+static bool printw_long = FALSE;
+
+void PDC_printw_free(void)
+{
+    free(printw_buf);
+    printw_buf = NULL;
+    printw_size = 0;
+    printw_long = FALSE;
+}
+
 int vwprintw(WINDOW *win, const char *fmt, va_list varglist)
 {
     char printbuf[513];
+    char *buf = printbuf;
     int len;
 
     PDC_LOG(("vwprintw() - called\n"));
 
 #ifdef HAVE_VSNPRINTF
-    len = vsnprintf(printbuf, 512, fmt, varglist);
+    {
+        size_t size = sizeof(printbuf);
+        va_list args;
+
+        if (printw_long && printw_buf)
+        {
+            buf = printw_buf;
+            size = printw_size;
+        }
+
+        va_copy(args, varglist);
+        len = vsnprintf(buf, size, fmt, args);
+        va_end(args);
+
+        /* if it didn't fit, format it again in a buffer of the size
+           returned -- or, with older vsnprintf()s that return -1 when
+           the output is truncated, keep doubling the buffer */
+
+        while (len < 0 || (size_t)len >= size)
+        {
+            if (len < 0 && size >= _PRINTW_MAXGROW)
+                break;
+
+            size = (len < 0) ? size * 2 : (size_t)len + 1;
+
+            if (size > printw_size)
+            {
+                free(printw_buf);
+                printw_size = 0;
+
+                PDC_STAT(allocs, 1);
+                printw_buf = malloc(size);
+                if (!printw_buf)
+                    return ERR;
+
+                printw_size = size;
+            }
+
+            buf = printw_buf;
+            size = printw_size;
+
+            va_copy(args, varglist);
+            len = vsnprintf(buf, size, fmt, args);
+            va_end(args);
+        }
+
+        if (len < 0)
+            return ERR;
+
+        printw_long = ((size_t)len >= sizeof(printbuf));
+    }
 #else
     len = vsprintf(printbuf, fmt, varglist);
 #endif
-    return (waddstr(win, printbuf) == ERR) ? ERR : len;
+    return (waddnstr(win, buf, len) == ERR) ? ERR : len;
 }
 
 int printw(const char *fmt, ...)
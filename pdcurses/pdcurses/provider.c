@@ -0,0 +1,412 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+provider
+--------
+
+### Synopsis
+
+    typedef const chtype *(*PDC_LINEPROC)(void *data, int line,
+                                          chtype *buf, int ncols);
+
+    WINDOW *PDC_newpad_provider(int nlines, int ncols, PDC_LINEPROC proc,
+                                void *data);
+    WINDOW *PDC_newwin_provider(int nlines, int ncols, int begy, int begx,
+                                PDC_LINEPROC proc, void *data);
+    int PDC_provider_lines(WINDOW *win, int nlines);
+    int PDC_provider_scroll(WINDOW *win, int top);
+    int PDC_provider_top(WINDOW *win);
+    int PDC_provider_cache(WINDOW *win, int nlines);
+
+### Description
+
+   PDC_newpad_provider() creates a pad of nlines lines and ncols
+   columns whose contents come from a function, proc, instead of being
+   written to it -- for viewing a huge log file, say, without reading
+   it all in. The pad holds only the lines in view: each time
+   pnoutrefresh() or prefresh() shows it, proc is called for the lines
+   that have come into view since the last time, and no others. So
+   opening the pad is instant, and it uses the same memory whatever
+   the value of nlines.
+
+   PDC_newwin_provider() creates a window, like newwin(), that works
+   the same way, showing nlines lines of the provider's at a time --
+   for a list or table of any length, in a menu, say. Which lines it
+   shows is set with PDC_provider_scroll(), which makes line top of the
+   provider the first line in the window; it starts at 0. proc is
+   called when the window is next refreshed, for the lines that have
+   come into view, and no others. PDC_provider_top() returns the line
+   set. Until PDC_provider_lines() is called, the window has as many
+   lines as proc cares to provide.
+
+   proc is called with the data pointer given to PDC_newpad_provider()
+   or PDC_newwin_provider(), the number of the line wanted, from 0, and
+   a buffer of ncols cells. It returns a pointer to the line's cells:
+   either buf, filled in, or cells held elsewhere, such as in a
+   memory-mapped file of chtypes, which are then copied. If it returns
+   NULL, the line is left blank. Lines past nlines are blank.
+
+   PDC_provider_lines() changes the number of lines the pad or window
+   has, for a file that has grown, and makes the lines in view be
+   fetched again.
+
+   PDC_provider_cache() keeps the last nlines lines fetched, so that
+   scrolling back to them doesn't call proc again; this is for a proc
+   that's slow, such as one that formats the rows of a database query.
+   A cache of twice the number of lines shown is enough for scrolling
+   back and forth by a page. It's emptied by PDC_provider_lines(), and
+   an nlines of 0 removes it; there's none at first.
+
+   Lines in the pad or window can be written to, and read back, as
+   usual, but the line numbers are relative to the top of the part last
+   shown, and the changes last only until those lines are fetched
+   again. A provider pad or window can't have subpads or subwindows.
+
+### Return Value
+
+   PDC_newpad_provider() and PDC_newwin_provider() return a pointer to
+   the new pad or window, or NULL on error. PDC_provider_top() returns
+   the first line set, or ERR if the window isn't a provider window.
+   The other functions return OK, or ERR if the window isn't a provider
+   pad or window (or, for PDC_provider_scroll(), a provider window), or
+   on error.
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_newpad_provider   |    -   |    -    |   -
+   PDC_newwin_provider   |    -   |    -    |   -
+   PDC_provider_lines    |    -   |    -    |   -
+   PDC_provider_scroll   |    -   |    -    |   -
+   PDC_provider_top      |    -   |    -    |   -
+   PDC_provider_cache    |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct _pdc_provider
+{
+    PDC_LINEPROC proc;
+    void *data;
+    int nlines;             /* lines the provider has */
+    int top;                /* line held in the window's first line, or
+                               -1 if none are held */
+    int rows;               /* number of lines held */
+    int want;               /* for a window, the line to show first */
+    int ncache;             /* lines the cache holds, if any */
+    int cachecols;          /* and their length */
+    int *cached;            /* for each, the line in it, or -1 */
+    chtype *cache;
+};
+
+static WINDOW *_provider(WINDOW *win, int nlines, PDC_LINEPROC proc,
+                         void *data)
+{
+    struct _pdc_provider *p;
+
+    if (!win)
+        return (WINDOW *)NULL;
+
+    p = calloc(1, sizeof(struct _pdc_provider));
+    if (!p)
+    {
+        delwin(win);
+        return (WINDOW *)NULL;
+    }
+
+    PDC_STAT(allocs, 1);
+
+    p->proc = proc;
+    p->data = data;
+    p->nlines = nlines;
+    p->top = -1;
+
+    win->_provider = p;
+
+    return win;
+}
+
+WINDOW *PDC_newpad_provider(int nlines, int ncols, PDC_LINEPROC proc,
+                            void *data)
+{
+    PDC_LOG(("PDC_newpad_provider() - called: lines=%d cols=%d\n",
+             nlines, ncols));
+
+    if (nlines < 0 || !proc)
+        return (WINDOW *)NULL;
+
+    /* the pad holds as many lines as the screen can show; more are
+       added if it's shown in a bigger area */
+
+    return _provider(newpad(LINES > 0 ? LINES : 1, ncols), nlines,
+                     proc, data);
+}
+
+WINDOW *PDC_newwin_provider(int nlines, int ncols, int begy, int begx,
+                            PDC_LINEPROC proc, void *data)
+{
+    PDC_LOG(("PDC_newwin_provider() - called: lines=%d cols=%d\n",
+             nlines, ncols));
+
+    if (!proc)
+        return (WINDOW *)NULL;
+
+    return _provider(newwin(nlines, ncols, begy, begx), INT_MAX,
+                     proc, data);
+}
+
+int PDC_provider_lines(WINDOW *win, int nlines)
+{
+    struct _pdc_provider *p;
+    int i;
+
+    PDC_LOG(("PDC_provider_lines() - called: lines=%d\n", nlines));
+
+    if (!win || !win->_provider || nlines < 0)
+        return ERR;
+
+    p = win->_provider;
+
+    p->nlines = nlines;
+    p->top = -1;
+
+    for (i = 0; i < p->ncache; i++)
+        p->cached[i] = -1;
+
+    return OK;
+}
+
+int PDC_provider_scroll(WINDOW *win, int top)
+{
+    PDC_LOG(("PDC_provider_scroll() - called: top=%d\n", top));
+
+    if (!win || !win->_provider || (win->_flags & _PAD) || top < 0)
+        return ERR;
+
+    win->_provider->want = top;
+
+    return OK;
+}
+
+int PDC_provider_top(WINDOW *win)
+{
+    PDC_LOG(("PDC_provider_top() - called\n"));
+
+    if (!win || !win->_provider || (win->_flags & _PAD))
+        return ERR;
+
+    return win->_provider->want;
+}
+
+int PDC_provider_cache(WINDOW *win, int nlines)
+{
+    struct _pdc_provider *p;
+    int *cached = NULL;
+    chtype *cache = NULL;
+    int i;
+
+    PDC_LOG(("PDC_provider_cache() - called: lines=%d\n", nlines));
+
+    if (!win || !win->_provider || nlines < 0)
+        return ERR;
+
+    p = win->_provider;
+
+    if (nlines)
+    {
+        cached = malloc(nlines * sizeof(int));
+        cache = malloc((size_t)nlines * win->_maxx * sizeof(chtype));
+
+        if (!cached || !cache)
+        {
+            free(cached);
+            free(cache);
+            return ERR;
+        }
+
+        PDC_STAT(allocs, 2);
+
+        for (i = 0; i < nlines; i++)
+            cached[i] = -1;
+    }
+
+    free(p->cached);
+    free(p->cache);
+
+    p->ncache = nlines;
+    p->cachecols = win->_maxx;
+    p->cached = cached;
+    p->cache = cache;
+
+    return OK;
+}
+
+void PDC_provider_free(WINDOW *win)
+{
+    free(win->_provider->cached);
+    free(win->_provider->cache);
+    free(win->_provider);
+    win->_provider = NULL;
+}
+
+/* get line of the provider into buf, from the cache if it's there, and
+   return its cells, or NULL if it's blank */
+
+static const chtype *_get(WINDOW *win, int line, chtype *buf)
+{
+    struct _pdc_provider *p = win->_provider;
+    const chtype *src;
+    chtype *slot;
+    int i;
+
+    if (line >= p->nlines)
+        return NULL;
+
+    /* the window may have been resized since the cache was made */
+
+    if (p->ncache && p->cachecols != win->_maxx &&
+        PDC_provider_cache(win, p->ncache) == ERR)
+        PDC_provider_cache(win, 0);
+
+    if (!p->ncache)
+        return p->proc(p->data, line, buf, win->_maxx);
+
+    /* each line has one place in the cache, so it holds the last
+       ncache lines fetched that are near each other */
+
+    i = line % p->ncache;
+    slot = p->cache + (size_t)i * win->_maxx;
+
+    if (p->cached[i] == line)
+        return slot;
+
+    src = p->proc(p->data, line, buf, win->_maxx);
+
+    if (src)
+    {
+        memcpy(slot, src, win->_maxx * sizeof(chtype));
+        p->cached[i] = line;
+    }
+    else
+        p->cached[i] = -1;
+
+    return src;
+}
+
+/* fetch line y of win, which is line top + y of the provider */
+
+static void _fetch(WINDOW *win, int y)
+{
+    const chtype *src;
+
+    PDC_COW_WRITE(win, y);
+
+    src = _get(win, win->_provider->top + y, win->_y[y]);
+
+    if (!src)
+        PDC_fill(win->_y[y], win->_bkgd, win->_maxx);
+    else if (src != win->_y[y])
+        memcpy(win->_y[y], src, win->_maxx * sizeof(chtype));
+
+    win->_firstch[y] = 0;
+    win->_lastch[y] = win->_maxx - 1;
+}
+
+/* make win hold nrows lines of the provider from top, fetching only
+   those it doesn't hold already */
+
+int PDC_provider_show(WINDOW *win, int top, int nrows)
+{
+    struct _pdc_provider *p = win->_provider;
+    chtype *temp;
+    int i, y, n, dir, start, end, first, last;
+
+    if (nrows > win->_maxy && !resize_window(win, nrows, win->_maxx))
+        return ERR;
+
+    PDC_LAZY_FLUSH(win);
+
+    n = top - p->top;
+
+    if (p->top < 0 || p->rows != win->_maxy || abs(n) >= win->_maxy)
+    {
+        p->top = top;
+        p->rows = win->_maxy;
+
+        for (y = 0; y < win->_maxy; y++)
+            _fetch(win, y);
+
+        return OK;
+    }
+
+    if (!n)
+        return OK;
+
+    /* rotate the lines still in view into place, as wscrl() does, and
+       fetch the rest. In a pad, the lines moved keep their changes, so
+       that pnoutrefresh() can move them on the screen, rather than copy
+       them again; a window is copied to the screen where it is, so they
+       must all be copied. */
+
+    if (n > 0)
+    {
+        start = 0;
+        end = win->_maxy - 1;
+        dir = 1;
+    }
+    else
+    {
+        start = win->_maxy - 1;
+        end = 0;
+        dir = -1;
+    }
+
+    for (i = 0; i < n * dir; i++)
+    {
+        PDC_COW_ROTATE(win, start, end, dir);
+
+        temp = win->_y[start];
+        first = win->_firstch[start];
+        last = win->_lastch[start];
+
+        for (y = start; y != end; y += dir)
+        {
+            win->_y[y] = win->_y[y + dir];
+            win->_firstch[y] = win->_firstch[y + dir];
+            win->_lastch[y] = win->_lastch[y + dir];
+        }
+
+        win->_y[end] = temp;
+        win->_firstch[end] = first;
+        win->_lastch[end] = last;
+    }
+
+    p->top = top;
+
+    for (y = 0; y < win->_maxy; y++)
+    {
+        if (n > 0 ? y >= win->_maxy - n : y < -n)
+            _fetch(win, y);
+        else if (!(win->_flags & _PAD))
+        {
+            win->_firstch[y] = 0;
+            win->_lastch[y] = win->_maxx - 1;
+        }
+    }
+
+    return OK;
+}
+
+/* for a window, show the lines set by PDC_provider_scroll() */
+
+int PDC_provider_refresh(WINDOW *win)
+{
+    return PDC_provider_show(win, win->_provider->want, win->_maxy);
+}
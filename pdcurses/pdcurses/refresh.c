@@ -63,6 +63,7 @@ int wnoutrefresh(WINDOW *win)
 {
     int begy, begx;     /* window's place on screen   */
     int i, j;
+    long cells = 0;
 
     PDC_LOG(("wnoutrefresh() - called: win=%p\n", win));
 
@@ -77,6 +78,15 @@ int wnoutrefresh(WINDOW *win)
 				win->_pad._pad_bottom,
 				win->_pad._pad_right);
 
+    /* a provider window fetches the lines that have come into view */
+
+    if (win->_provider && PDC_provider_refresh(win) == ERR)
+        return ERR;
+
+    PDC_BENCH_BEGIN(PDC_STAGE_WNOUTREFRESH);
+
+    PDC_LAZY_FLUSH(win);
+
     begy = win->_begy;
     begx = win->_begx;
 
@@ -103,8 +113,12 @@ int wnoutrefresh(WINDOW *win)
 
             if (first <= last)
             {
+                PDC_COW_WRITE(curscr, j);
+
+                dest = curscr->_y[j] + begx;
                 memcpy(dest + first, src + first,
                        (last - first + 1) * sizeof(chtype));
+                cells += last - first + 1;
 
                 first += begx;
                 last += begx;
@@ -132,6 +146,9 @@ int wnoutrefresh(WINDOW *win)
         curscr->_curx = win->_curx + begx;
     }
 
+    PDC_STAT(cells_copied, cells);
+    PDC_BENCH_END(PDC_STAGE_WNOUTREFRESH, cells);
+
     return OK;
 }
 
@@ -145,6 +162,15 @@ int doupdate(void)
     if (!SP || !curscr)
         return ERR;
 
+    /* while the screen can't be seen, the changes build up in curscr,
+       to be drawn all at once when it can */
+
+    if (SP->suspended && !isendwin())
+        return OK;
+
+    PDC_BENCH_BEGIN(PDC_STAGE_DOUPDATE);
+    PDC_STAT(updates, 1);
+
     if (isendwin())         /* coming back after endwin() called */
     {
         reset_prog_mode();
@@ -176,6 +202,8 @@ int doupdate(void)
             {
                 first = curscr->_firstch[y];
                 last = curscr->_lastch[y];
+
+                PDC_STAT(cells_compared, last - first + 1);
             }
 
             while (first <= last)
@@ -201,7 +229,11 @@ int doupdate(void)
 
                 if (len)
                 {
+                    PDC_BENCH_BEGIN(PDC_STAGE_TRANSFORM);
                     PDC_transform_line(y, first, len, src + first);
+                    PDC_BENCH_END(PDC_STAGE_TRANSFORM, len);
+                    PDC_STAT(runs, 1);
+                    PDC_STAT(cells_drawn, len);
                     memcpy(dest + first, src + first, len * sizeof(chtype));
                     first += len;
                 }
@@ -225,7 +257,11 @@ int doupdate(void)
     SP->cursrow = curscr->_cury;
     SP->curscol = curscr->_curx;
 
+    PDC_BENCH_BEGIN(PDC_STAGE_PRESENT);
     PDC_doupdate();
+    PDC_BENCH_END(PDC_STAGE_PRESENT, 0);
+
+    PDC_BENCH_END(PDC_STAGE_DOUPDATE, 0);
 
     return OK;
 }
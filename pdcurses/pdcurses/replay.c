@@ -0,0 +1,337 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+replay
+------
+
+### Synopsis
+
+    int PDC_record_input(const char *filename);
+    int PDC_replay_input(const char *filename, bool realtime);
+
+### Description
+
+   PDC_record_input() starts logging every key and mouse event that
+   wgetch() receives from the platform layer to the named file, together
+   with the mouse status, the key modifiers and a virtual timestamp.
+   Events that produce no key are not logged. Calling it with a NULL
+   filename stops the recording and closes the file.
+
+   PDC_replay_input() feeds a log made by PDC_record_input() back to
+   wgetch(), in place of the real keyboard and mouse. When the end of
+   the log is reached, replay stops, and input comes from the platform
+   again. Calling it with a NULL filename stops a replay early.
+
+   The timestamps are virtual: they count the milliseconds the program
+   has spent in napms(), including the delays made by wgetch() itself
+   while it waits for input, rather than wall-clock time. A replayed
+   event is delivered once the program has slept for as long as it had
+   when the event was recorded, so timeouts, halfdelay() and nodelay()
+   loops see the input at the same points on every run. If realtime is
+   FALSE, napms() returns at once instead of sleeping during the replay,
+   so the session runs as fast as the program can process it; if TRUE,
+   napms() sleeps as usual, reproducing the recorded pacing.
+
+   If the environment variable PDC_RECORD is set to a filename when
+   initscr() is called, recording to that file starts automatically.
+   Likewise, PDC_REPLAY names a log to replay, at full speed unless
+   PDC_REPLAY_REALTIME is also set. This allows sessions of existing
+   programs, such as the demos, to be captured and replayed without
+   changing them.
+
+### Return Value
+
+   These functions return OK on success, or ERR if the file could not
+   be opened, or is not a PDCurses input log.
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_record_input      |    -   |    -    |   -
+   PDC_replay_input      |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/* A log starts with the signature "PDCrec" followed by a NUL and a
+   version byte. Each event is then a flags byte, followed by unsigned
+   LEB128 numbers (seven bits per byte, least significant first, high
+   bit set on all but the last byte): the time since the previous event,
+   the key and the key modifiers; then, for mouse events, x and y
+   (zigzag-encoded, as they may be negative), the three button states
+   and the changes mask. This keeps the common case to four or five
+   bytes per key, and doesn't depend on the host's byte order or word
+   size. */
+
+#define _REC_VERSION 1
+
+#define _REC_KEYCODE 0x01  /* SP->key_code was set */
+#define _REC_MOUSE   0x02  /* mouse status follows */
+
+static const char rec_sig[8] = {'P', 'D', 'C', 'r', 'e', 'c', 0,
+                                _REC_VERSION};
+
+static FILE *recfp = NULL;          /* log being recorded */
+static FILE *playfp = NULL;         /* log being replayed */
+static bool play_realtime = FALSE;  /* sleep in napms() while replaying */
+static unsigned long vclock = 0;    /* virtual time, in ms of napms() */
+static unsigned long rec_last = 0;  /* time of last recorded event */
+
+static struct
+{
+    bool valid;             /* an event has been read ahead */
+    unsigned long when;     /* virtual time to deliver it */
+    int flags;
+    int key;
+    unsigned long modifiers;
+    MOUSE_STATUS mouse;
+} next;
+
+static void _put_num(unsigned long num)
+{
+    while (num > 0x7f)
+    {
+        putc((int)(num & 0x7f) | 0x80, recfp);
+        num >>= 7;
+    }
+
+    putc((int)num, recfp);
+}
+
+static void _put_int(int num)
+{
+    _put_num(num < 0 ? ((unsigned long)~num << 1) | 1 :
+                       (unsigned long)num << 1);
+}
+
+static bool _get_num(unsigned long *num)
+{
+    int c, shift = 0;
+
+    *num = 0;
+
+    do
+    {
+        c = getc(playfp);
+        if (c == EOF || shift >= (int)sizeof(unsigned long) * 8)
+            return FALSE;
+
+        *num |= (unsigned long)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    return TRUE;
+}
+
+static bool _get_int(int *num)
+{
+    unsigned long n;
+
+    if (!_get_num(&n))
+        return FALSE;
+
+    *num = (n & 1) ? (int)~(n >> 1) : (int)(n >> 1);
+
+    return TRUE;
+}
+
+static void _record(int key)
+{
+    int i, flags = 0;
+
+    if (SP->key_code)
+    {
+        flags |= _REC_KEYCODE;
+
+        if (key == KEY_MOUSE)
+            flags |= _REC_MOUSE;
+    }
+
+    putc(flags, recfp);
+    _put_num(vclock - rec_last);
+    _put_num((unsigned long)key);
+    _put_num(SP->key_modifiers);
+
+    rec_last = vclock;
+
+    if (flags & _REC_MOUSE)
+    {
+        _put_int(SP->mouse_status.x);
+        _put_int(SP->mouse_status.y);
+
+        for (i = 0; i < 3; i++)
+            _put_num((unsigned short)SP->mouse_status.button[i]);
+
+        _put_num((unsigned long)SP->mouse_status.changes);
+    }
+}
+
+static bool _read_next(void)
+{
+    unsigned long delta, key, num;
+    int i, flags = getc(playfp);
+
+    if (flags == EOF || !_get_num(&delta) || !_get_num(&key) ||
+        !_get_num(&next.modifiers))
+        return FALSE;
+
+    next.flags = flags;
+    next.key = (int)key;
+    next.when += delta;
+
+    if (flags & _REC_MOUSE)
+    {
+        if (!_get_int(&next.mouse.x) || !_get_int(&next.mouse.y))
+            return FALSE;
+
+        for (i = 0; i < 3; i++)
+        {
+            if (!_get_num(&num))
+                return FALSE;
+
+            next.mouse.button[i] = (short)num;
+        }
+
+        if (!_get_num(&num))
+            return FALSE;
+
+        next.mouse.changes = (int)num;
+    }
+
+    next.valid = TRUE;
+
+    return TRUE;
+}
+
+static void _stop_replay(void)
+{
+    if (playfp)
+    {
+        fclose(playfp);
+        playfp = NULL;
+    }
+
+    next.valid = FALSE;
+}
+
+int PDC_record_input(const char *filename)
+{
+    PDC_LOG(("PDC_record_input() - called: filename=%s\n",
+             filename ? filename : "(null)"));
+
+    if (recfp)
+    {
+        fclose(recfp);
+        recfp = NULL;
+    }
+
+    if (!filename)
+        return OK;
+
+    recfp = fopen(filename, "wb");
+    if (!recfp)
+        return ERR;
+
+    fwrite(rec_sig, sizeof(rec_sig), 1, recfp);
+    rec_last = vclock;
+
+    return OK;
+}
+
+int PDC_replay_input(const char *filename, bool realtime)
+{
+    char sig[sizeof(rec_sig)];
+
+    PDC_LOG(("PDC_replay_input() - called: filename=%s\n",
+             filename ? filename : "(null)"));
+
+    _stop_replay();
+
+    if (!filename)
+        return OK;
+
+    playfp = fopen(filename, "rb");
+    if (!playfp)
+        return ERR;
+
+    if (fread(sig, sizeof(sig), 1, playfp) != 1 ||
+        memcmp(sig, rec_sig, sizeof(sig)))
+    {
+        _stop_replay();
+        return ERR;
+    }
+
+    play_realtime = realtime;
+    next.when = vclock;
+
+    return OK;
+}
+
+void PDC_replay_init(void)
+{
+    const char *env;
+
+    if (!recfp && (env = getenv("PDC_RECORD")) != NULL)
+        PDC_record_input(env);
+
+    if (!playfp && (env = getenv("PDC_REPLAY")) != NULL)
+        PDC_replay_input(env, !!getenv("PDC_REPLAY_REALTIME"));
+}
+
+/* stand-ins for PDC_check_key() and PDC_get_key() in wgetch(), which
+   take events from the log while replaying, and add them to the log
+   while recording */
+
+bool PDC_check_input(void)
+{
+    if (playfp)
+    {
+        if (next.valid || _read_next())
+            return next.when <= vclock;
+
+        _stop_replay();
+    }
+
+    return PDC_check_key();
+}
+
+int PDC_get_input(void)
+{
+    int key;
+
+    if (next.valid)
+    {
+        key = next.key;
+
+        SP->key_code = !!(next.flags & _REC_KEYCODE);
+        SP->key_modifiers = next.modifiers;
+
+        if (next.flags & _REC_MOUSE)
+            SP->mouse_status = next.mouse;
+
+        next.valid = FALSE;
+    }
+    else
+        key = PDC_get_key();
+
+    if (recfp && key != -1)
+        _record(key);
+
+    return key;
+}
+
+/* advance the virtual clock by ms; returns FALSE if napms() should skip
+   the real delay */
+
+bool PDC_advance_clock(int ms)
+{
+    vclock += ms;
+
+    return !playfp || play_realtime;
+}
@@ -26,6 +26,13 @@ scr_dump
    an unspecified format. This information can be retrieved later using
    getwin().
 
+   In PDCurses, the format is compressed: runs of repeated cells, and of
+   cells unchanged from the line above, are stored once, so a dump of a
+   mostly blank or mostly text screen takes a few bytes per line. It's
+   independent of the host's byte order and word size, and is read
+   strictly in sequence, so getwin() can read from a pipe, or from
+   memory opened with fmemopen().
+
    scr_dump() writes the current contents of the virtual screen to the
    file named by filename in an unspecified format.
 
@@ -62,99 +69,361 @@ scr_dump
 #include <stdlib.h>
 #include <string.h>
 
-#define DUMPVER 1   /* Should be updated whenever the WINDOW struct is
-                       changed */
+/* A dump starts with "PDC" and a version byte. Everything after that is
+   unsigned LEB128 numbers, as in the input logs made by replay.c, so
+   the format doesn't depend on the host's byte order or word size;
+   values that may be negative are zigzag-encoded.
 
-int putwin(WINDOW *win, FILE *filep)
+   The header gives the size, position, cursor, flags, attributes,
+   background, options, margins, delay, parent offset and pad position
+   of the window. Then each line is a sequence of runs, each introduced
+   by a number whose low two bits give its kind, and whose remaining
+   bits give a count n:
+
+       _RUN_LITERAL  n cells follow, as their characters
+       _RUN_REPEAT   one character follows, which fills n cells
+       _RUN_ATTR     no cells; n is the attributes (shifted down) of
+                     the cells that follow, until the next _RUN_ATTR
+       _RUN_ABOVE    n cells are the same as in the line above
+
+   A blank line takes two or three bytes, and a line of plain text
+   little more than one byte per character. Runs never span lines, and
+   nothing refers ahead, so a dump can be read in one pass from a pipe,
+   or from memory with fmemopen(). */
+
+#define DUMPVER 4   /* Should be updated whenever the format changes */
+
+#define _RUN_LITERAL 0
+#define _RUN_REPEAT  1
+#define _RUN_ATTR    2
+#define _RUN_ABOVE   3
+
+#define _ATTR_SHIFT  16     /* of A_ATTRIBUTES */
+
+/* the shortest runs of repeated or unchanged cells worth encoding as
+   such, rather than as part of a literal */
+
+#define _MIN_REPEAT  3
+#define _MIN_ABOVE   4
+
+/* the window's options, stored as one number */
+
+#define _OPT_CLEAR   0x01
+#define _OPT_LEAVEIT 0x02
+#define _OPT_SCROLL  0x04
+#define _OPT_NODELAY 0x08
+#define _OPT_IMMED   0x10
+#define _OPT_SYNC    0x20
+#define _OPT_KEYPAD  0x40
+
+static void _put_num(FILE *filep, unsigned long num)
 {
-    static const char *marker = "PDC";
-    static const unsigned char version = DUMPVER;
+    while (num > 0x7f)
+    {
+        putc((int)(num & 0x7f) | 0x80, filep);
+        num >>= 7;
+    }
 
-    PDC_LOG(("putwin() - called\n"));
+    putc((int)num, filep);
+}
+
+static void _put_int(FILE *filep, int num)
+{
+    _put_num(filep, num < 0 ? ((unsigned long)~num << 1) | 1 :
+                              (unsigned long)num << 1);
+}
+
+static bool _get_num(FILE *filep, unsigned long *num)
+{
+    int c, shift = 0;
+
+    *num = 0;
+
+    do
+    {
+        c = getc(filep);
+        if (c == EOF || shift >= (int)sizeof(unsigned long) * 8)
+            return FALSE;
+
+        *num |= (unsigned long)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    return TRUE;
+}
+
+static bool _get_int(FILE *filep, int *num)
+{
+    unsigned long n;
+
+    if (!_get_num(filep, &n))
+        return FALSE;
+
+    *num = (n & 1) ? (int)~(n >> 1) : (int)(n >> 1);
+
+    return TRUE;
+}
+
+/* the number of cells from x, up to limit, that match the line above */
+
+static int _above(const chtype *line, const chtype *above, int x, int limit)
+{
+    int n = 0;
+
+    if (above)
+        while (x + n < limit && line[x + n] == above[x + n])
+            n++;
+
+    return n;
+}
+
+/* the number of cells from x, up to limit, that are the same as
+   line[x] */
+
+static int _repeat(const chtype *line, int x, int limit)
+{
+    int n = 1;
+
+    while (x + n < limit && line[x + n] == line[x])
+        n++;
+
+    return n;
+}
+
+static void _put_line(FILE *filep, const chtype *line, const chtype *above,
+                      int ncols, chtype *attr)
+{
+    int x = 0, n, end;
 
-    /* write the marker and the WINDOW struct */
+    while (x < ncols)
+    {
+        n = _above(line, above, x, ncols);
+        if (n >= _MIN_ABOVE)
+        {
+            _put_num(filep, ((unsigned long)n << 2) | _RUN_ABOVE);
+            x += n;
+            continue;
+        }
+
+        if ((line[x] & A_ATTRIBUTES) != *attr)
+        {
+            *attr = line[x] & A_ATTRIBUTES;
+            _put_num(filep, ((unsigned long)(*attr >> _ATTR_SHIFT) << 2) |
+                            _RUN_ATTR);
+        }
+
+        n = _repeat(line, x, ncols);
+        if (n >= _MIN_REPEAT)
+        {
+            _put_num(filep, ((unsigned long)n << 2) | _RUN_REPEAT);
+            _put_num(filep, line[x] & A_CHARTEXT);
+            x += n;
+            continue;
+        }
+
+        /* a literal ends where the attributes change, or where a run of
+           another kind would start */
+
+        for (end = x + 1; end < ncols; end++)
+            if ((line[end] & A_ATTRIBUTES) != *attr ||
+                (end + _MIN_REPEAT <= ncols &&
+                 _repeat(line, end, end + _MIN_REPEAT) == _MIN_REPEAT) ||
+                (end + _MIN_ABOVE <= ncols &&
+                 _above(line, above, end, end + _MIN_ABOVE) == _MIN_ABOVE))
+                break;
+
+        _put_num(filep, ((unsigned long)(end - x) << 2) | _RUN_LITERAL);
 
-    if (filep && fwrite(marker, strlen(marker), 1, filep)
-              && fwrite(&version, 1, 1, filep)
-              && fwrite(win, sizeof(WINDOW), 1, filep))
+        for (; x < end; x++)
+            _put_num(filep, line[x] & A_CHARTEXT);
+    }
+}
+
+static bool _get_line(FILE *filep, chtype *line, const chtype *above,
+                      int ncols, chtype *attr)
+{
+    unsigned long run, ch;
+    int x = 0, n;
+
+    while (x < ncols)
     {
-        int i;
+        if (!_get_num(filep, &run))
+            return FALSE;
+
+        if ((run & 3) == _RUN_ATTR)
+        {
+            *attr = ((chtype)(run >> 2) << _ATTR_SHIFT) & A_ATTRIBUTES;
+            continue;
+        }
 
-        /* write each line */
+        if (!(run >> 2) || (run >> 2) > (unsigned long)(ncols - x))
+            return FALSE;
 
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (!fwrite(win->_y[i], win->_maxx * sizeof(chtype), 1, filep))
-                return ERR;
+        n = (int)(run >> 2);
 
-        return OK;
+        switch (run & 3)
+        {
+        case _RUN_ABOVE:
+            if (!above)
+                return FALSE;
+
+            memcpy(line + x, above + x, n * sizeof(chtype));
+            x += n;
+            break;
+
+        case _RUN_REPEAT:
+            if (!_get_num(filep, &ch))
+                return FALSE;
+
+            PDC_fill(line + x, *attr | ((chtype)ch & A_CHARTEXT), n);
+            x += n;
+            break;
+
+        default:
+            for (n += x; x < n; x++)
+            {
+                if (!_get_num(filep, &ch))
+                    return FALSE;
+
+                line[x] = *attr | ((chtype)ch & A_CHARTEXT);
+            }
+        }
     }
 
-    return ERR;
+    return TRUE;
+}
+
+int putwin(WINDOW *win, FILE *filep)
+{
+    static const char marker[4] = {'P', 'D', 'C', DUMPVER};
+    chtype attr = 0;
+    int i, opts;
+
+    PDC_LOG(("putwin() - called\n"));
+
+    if (!win || !filep || !fwrite(marker, sizeof(marker), 1, filep))
+        return ERR;
+
+    PDC_LAZY_FLUSH(win);
+
+    opts = (win->_clear ? _OPT_CLEAR : 0) |
+           (win->_leaveit ? _OPT_LEAVEIT : 0) |
+           (win->_scroll ? _OPT_SCROLL : 0) |
+           (win->_nodelay ? _OPT_NODELAY : 0) |
+           (win->_immed ? _OPT_IMMED : 0) |
+           (win->_sync ? _OPT_SYNC : 0) |
+           (win->_use_keypad ? _OPT_KEYPAD : 0);
+
+    /* write the header, then each line */
+
+    _put_num(filep, win->_maxy);
+    _put_num(filep, win->_maxx);
+    _put_int(filep, win->_begy);
+    _put_int(filep, win->_begx);
+    _put_num(filep, win->_cury);
+    _put_num(filep, win->_curx);
+    _put_num(filep, win->_flags);
+    _put_num(filep, win->_attrs);
+    _put_num(filep, win->_bkgd);
+    _put_num(filep, opts);
+    _put_num(filep, win->_tmarg);
+    _put_num(filep, win->_bmarg);
+    _put_int(filep, win->_delayms);
+    _put_int(filep, win->_parx);
+    _put_int(filep, win->_pary);
+    _put_int(filep, win->_pad._pad_y);
+    _put_int(filep, win->_pad._pad_x);
+    _put_int(filep, win->_pad._pad_top);
+    _put_int(filep, win->_pad._pad_left);
+    _put_int(filep, win->_pad._pad_bottom);
+    _put_int(filep, win->_pad._pad_right);
+
+    for (i = 0; i < win->_maxy; i++)
+        _put_line(filep, win->_y[i], i ? win->_y[i - 1] : NULL,
+                  win->_maxx, &attr);
+
+    return ferror(filep) ? ERR : OK;
 }
 
 WINDOW *getwin(FILE *filep)
 {
     WINDOW *win;
     char marker[4];
-    int i, nlines, ncols;
+    unsigned long size[2], num[8];
+    int i, org[2], val[9];
+    chtype attr = 0;
 
     PDC_LOG(("getwin() - called\n"));
 
-    win = malloc(sizeof(WINDOW));
-    if (!win)
-        return (WINDOW *)NULL;
-
-    /* check for the marker, and load the WINDOW struct */
+    /* check for the marker, and read the header, in the order putwin()
+       writes it */
 
     if (!filep || !fread(marker, 4, 1, filep) || strncmp(marker, "PDC", 3)
-        || marker[3] != DUMPVER || !fread(win, sizeof(WINDOW), 1, filep))
-    {
-        free(win);
+        || marker[3] != DUMPVER)
         return (WINDOW *)NULL;
-    }
 
-    nlines = win->_maxy;
-    ncols = win->_maxx;
+    for (i = 0; i < 2; i++)
+        if (!_get_num(filep, size + i))
+            return (WINDOW *)NULL;
 
-    /* allocate the line pointer array */
+    for (i = 0; i < 2; i++)
+        if (!_get_int(filep, org + i))
+            return (WINDOW *)NULL;
 
-    win->_y = malloc(nlines * sizeof(chtype *));
-    if (!win->_y)
-    {
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    for (i = 0; i < 8; i++)
+        if (!_get_num(filep, num + i))
+            return (WINDOW *)NULL;
 
-    /* allocate the minchng and maxchng arrays */
+    for (i = 0; i < 9; i++)
+        if (!_get_int(filep, val + i))
+            return (WINDOW *)NULL;
 
-    win->_firstch = malloc(nlines * sizeof(int));
-    if (!win->_firstch)
-    {
-        free(win->_y);
-        free(win);
+    if (!size[0] || !size[1] || size[0] > 0x7fff || size[1] > 0x7fff ||
+        num[0] >= size[0] || num[1] >= size[1] || num[6] > num[7] ||
+        num[7] >= size[0])
         return (WINDOW *)NULL;
-    }
 
-    win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
-    {
-        free(win->_firstch);
-        free(win->_y);
-        free(win);
+    win = PDC_makenew((int)size[0], (int)size[1], org[0], org[1]);
+    if (!win)
         return (WINDOW *)NULL;
-    }
 
-    /* allocate the lines */
+    win->_cury = (int)num[0];
+    win->_curx = (int)num[1];
+
+    /* the window has lines of its own, even if it was a subwindow */
+
+    win->_flags = (int)num[2] & ~(_SUBWIN|_SUBPAD);
+    win->_attrs = (chtype)num[3];
+    win->_bkgd = (chtype)num[4];
+    win->_clear = !!(num[5] & _OPT_CLEAR);
+    win->_leaveit = !!(num[5] & _OPT_LEAVEIT);
+    win->_scroll = !!(num[5] & _OPT_SCROLL);
+    win->_nodelay = !!(num[5] & _OPT_NODELAY);
+    win->_immed = !!(num[5] & _OPT_IMMED);
+    win->_sync = !!(num[5] & _OPT_SYNC);
+    win->_use_keypad = !!(num[5] & _OPT_KEYPAD);
+    win->_tmarg = (int)num[6];
+    win->_bmarg = (int)num[7];
+    win->_delayms = val[0];
+    win->_parx = val[1];
+    win->_pary = val[2];
+    win->_pad._pad_y = val[3];
+    win->_pad._pad_x = val[4];
+    win->_pad._pad_top = val[5];
+    win->_pad._pad_left = val[6];
+    win->_pad._pad_bottom = val[7];
+    win->_pad._pad_right = val[8];
 
     win = PDC_makelines(win);
     if (!win)
         return (WINDOW *)NULL;
 
-    /* read them */
+    /* read the lines */
 
-    for (i = 0; i < nlines; i++)
+    for (i = 0; i < win->_maxy; i++)
     {
-        if (!fread(win->_y[i], ncols * sizeof(chtype), 1, filep))
+        if (!_get_line(filep, win->_y[i], i ? win->_y[i - 1] : NULL,
+                       win->_maxx, &attr))
         {
             delwin(win);
             return (WINDOW *)NULL;
@@ -50,6 +50,8 @@ int wscrl(WINDOW *win, int n)
     if (!win || !win->_scroll || !n)
         return ERR;
 
+    PDC_LAZY_FLUSH(win);
+
     blank = win->_bkgd;
 
     if (n > 0)
@@ -67,6 +69,9 @@ int wscrl(WINDOW *win, int n)
 
     for (l = 0; l < (n * dir); l++)
     {
+        PDC_COW_WRITE(win, start);
+        PDC_COW_ROTATE(win, start, end, dir);
+
         temp = win->_y[start];
 
         /* re-arrange line pointers */
@@ -78,8 +83,7 @@ int wscrl(WINDOW *win, int n)
 
         /* make a blank line */
 
-        for (i = 0; i < win->_maxx; i++)
-            *temp++ = blank;
+        PDC_fill(temp, blank, win->_maxx);
     }
 
     touchline(win, win->_tmarg, win->_bmarg - win->_tmarg + 1);
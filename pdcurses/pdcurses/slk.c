@@ -149,6 +149,7 @@ int slk_init(int fmt)
 
     label_fmt = fmt;
 
+    PDC_STAT(allocs, 1);
     slk = calloc(labels, sizeof(struct SLK));
 
     if (!slk)
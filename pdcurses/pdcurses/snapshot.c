@@ -0,0 +1,592 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+snapshot
+--------
+
+### Synopsis
+
+    PDC_SNAPSHOT *PDC_snapshot(WINDOW *win);
+    int PDC_restore_snapshot(WINDOW *win, const PDC_SNAPSHOT *snap);
+    void PDC_free_snapshot(PDC_SNAPSHOT *snap);
+
+### Description
+
+   PDC_snapshot() saves the contents of a window, with its cursor
+   position, attributes and background, so that PDC_restore_snapshot()
+   can put them back later -- for undo, under a modal dialog, or when
+   switching between views. The snapshot shares the window's lines
+   instead of copying them, so taking one costs time in proportion to
+   the number of lines, not cells. A line is copied only when it's
+   first written to afterwards, through the window or any window
+   sharing it.
+
+   PDC_restore_snapshot() copies a snapshot into win, which must be the
+   same size as the window it was taken from. Only the cells that
+   differ are marked as changed; lines of the original window that
+   haven't been written to since the snapshot was taken are skipped. A
+   snapshot can be restored any number of times, and into any window of
+   the right size.
+
+   PDC_free_snapshot() releases a snapshot. A snapshot stays valid after
+   the window it was taken from is deleted.
+
+   dupwin() shares lines with the original window in the same way.
+
+### Return Value
+
+   PDC_snapshot() returns a pointer to the new snapshot, or NULL on
+   error. PDC_restore_snapshot() returns OK on success, or ERR if the
+   window isn't the same size as the snapshot.
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_snapshot          |    -   |    -    |   -
+   PDC_restore_snapshot  |    -   |    -    |   -
+   PDC_free_snapshot     |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/* A shared line has a PDC_COWLINE, held by each window and snapshot
+   using it. Its first holder, the owner, keeps its line buffer when it
+   writes, since its subwindows may point into it; the other holders
+   then move to a copy. A window made by dupwin() moves to a copy of its
+   own when it writes -- it can't have subwindows while it's sharing,
+   since subwin() and subpad() unshare it first. */
+
+struct _pdc_snapshot
+{
+    int nlines, ncols;
+    int cury, curx;
+    chtype attrs, bkgd;
+    PDC_COWLINE **line;
+    int *offset;            /* of the window's cells in each line */
+};
+
+static WINDOW *cow_windows = NULL;  /* windows sharing lines */
+
+static struct _pdc_cow *_cow_state(WINDOW *win)
+{
+    struct _pdc_cow *cow = win->_cow;
+
+    if (!cow)
+    {
+        cow = malloc(sizeof(struct _pdc_cow));
+        if (!cow)
+            return NULL;
+
+        cow->line = calloc(win->_maxy, sizeof(PDC_COWLINE *));
+        if (!cow->line)
+        {
+            free(cow);
+            return NULL;
+        }
+
+        PDC_STAT(allocs, 2);
+
+        cow->shared = 0;
+        cow->pages = NULL;
+        cow->next = cow_windows;
+        cow_windows = win;
+        win->_cow = cow;
+    }
+
+    return cow;
+}
+
+static void _cow_free(WINDOW *win)
+{
+    WINDOW **p;
+
+    for (p = &cow_windows; *p != win; p = &(*p)->_cow->next)
+        ;
+
+    *p = win->_cow->next;
+
+    free(win->_cow->line);
+    free(win->_cow);
+    win->_cow = NULL;
+}
+
+/* line y of win is no longer shared */
+
+static void _forget(WINDOW *win, int y)
+{
+    win->_cow->line[y] = NULL;
+
+    if (!--win->_cow->shared)
+        _cow_free(win);
+}
+
+/* the shared line for line y of a window with lines of its own, made
+   on first use */
+
+static PDC_COWLINE *_share(WINDOW *win, int y)
+{
+    struct _pdc_cow *cow = _cow_state(win);
+    PDC_COWLINE *line;
+
+    if (!cow)
+        return NULL;
+
+    line = cow->line[y];
+    if (!line)
+    {
+        line = malloc(sizeof(PDC_COWLINE));
+        if (!line)
+        {
+            if (!cow->shared)
+                _cow_free(win);
+            return NULL;
+        }
+
+        PDC_STAT(allocs, 1);
+
+        line->refs = 1;
+        line->dups = 0;
+        line->cells = win->_y[y];
+        line->owner = win;
+
+        cow->line[y] = line;
+        cow->shared++;
+    }
+
+    return line;
+}
+
+static void _drop(PDC_COWLINE *line)
+{
+    if (!--line->refs)
+    {
+        PDC_pool_free(line->cells);
+        free(line);
+    }
+}
+
+/* move the dupwin() windows holding line, which was at index y in the
+   owner, to cells */
+
+static void _repoint(PDC_COWLINE *line, int y, chtype *cells)
+{
+    WINDOW *w;
+    int i, left = line->dups;
+
+    for (w = cow_windows; w && left; w = w->_cow->next)
+    {
+        if (w == line->owner)
+            continue;
+
+        i = (y < w->_maxy && w->_cow->line[y] == line) ? y : 0;
+
+        for (; i < w->_maxy; i++)
+            if (w->_cow->line[i] == line)
+            {
+                w->_y[i] = cells;
+                left--;
+                break;
+            }
+    }
+}
+
+/* give line y of win (a window with lines of its own) a buffer that
+   nothing else holds */
+
+static void _unshare(WINDOW *win, int y)
+{
+    PDC_COWLINE *line = win->_cow->line[y];
+    size_t size = win->_maxx * sizeof(chtype);
+    chtype *copy;
+
+    if (!line)
+        return;
+
+    if (line->refs == 1)
+    {
+        /* it's already win's alone */
+
+        free(line);
+    }
+    else
+    {
+        /* if there's no memory for the copy, the write will be seen
+           by the other holders; there's nothing better to do */
+
+        copy = PDC_pool_alloc(size);
+        if (!copy)
+            return;
+
+        memcpy(copy, line->cells, size);
+
+        if (line->owner == win)
+        {
+            _repoint(line, y, copy);
+
+            line->cells = copy;
+            line->owner = NULL;
+        }
+        else
+        {
+            win->_y[y] = copy;
+            line->dups--;
+        }
+
+        line->refs--;
+    }
+
+    _forget(win, y);
+}
+
+/* the index in win's parent of the line holding line y of win, or -1
+   if the cells aren't the parent's (as with a window made by dupwin()
+   from a subwindow) */
+
+static int _parent_line(const WINDOW *win, int y)
+{
+    const WINDOW *par = win->_parent;
+    const chtype *ptr = win->_y[y];
+    int py = y + ((win->_flags & _SUBPAD) ? win->_begy : win->_pary);
+
+    if (py >= 0 && py < par->_maxy && ptr >= par->_y[py] &&
+        ptr < par->_y[py] + par->_maxx)
+        return py;
+
+    /* the lines of a subwindow are out of order after it's scrolled */
+
+    for (py = 0; py < par->_maxy; py++)
+        if (ptr >= par->_y[py] && ptr < par->_y[py] + par->_maxx)
+            return py;
+
+    return -1;
+}
+
+void PDC_cow_write(WINDOW *win, int y)
+{
+    WINDOW *w;
+
+    while (win->_parent)
+    {
+        for (w = win->_parent; w && !w->_cow; w = w->_parent)
+            ;
+
+        if (!w)
+            return;
+
+        y = _parent_line(win, y);
+        if (y < 0)
+            return;
+
+        win = win->_parent;
+    }
+
+    if (!win->_cow)
+        return;
+
+    if (win->_cow->pages)
+        PDC_page_write(win, y);
+    else
+        _unshare(win, y);
+}
+
+void PDC_cow_rotate(WINDOW *win, int start, int end, int dir)
+{
+    PDC_COWLINE **line = win->_cow->line;
+    PDC_COWLINE *temp;
+    int i;
+
+    /* a paged pad's lines are told apart by their pointers alone */
+
+    if (!line)
+        return;
+
+    temp = line[start];
+
+    for (i = start; i != end; i += dir)
+        line[i] = line[i + dir];
+
+    line[end] = temp;
+}
+
+/* share the lines of win with new, a window of the same size with no
+   lines yet */
+
+int PDC_cow_dup(WINDOW *win, WINDOW *new)
+{
+    struct _pdc_cow *cow;
+    PDC_COWLINE *line;
+    int y;
+
+    if (win->_parent || (win->_flags & (_SUBWIN|_SUBPAD)) ||
+        (win->_cow && win->_cow->pages))
+        return ERR;
+
+    for (y = 0; y < win->_maxy; y++)
+        if (!_share(win, y))
+            return ERR;
+
+    cow = _cow_state(new);
+    if (!cow)
+        return ERR;
+
+    for (y = 0; y < win->_maxy; y++)
+    {
+        line = win->_cow->line[y];
+        line->refs++;
+        line->dups++;
+
+        cow->line[y] = line;
+        new->_y[y] = line->cells;
+    }
+
+    cow->shared = win->_maxy;
+
+    return OK;
+}
+
+/* before a subwindow is made over nlines lines of win from begy, take
+   copies of those lines that win doesn't own, as they may move; or for
+   a paged pad, give them lines of their own, and keep them */
+
+void PDC_cow_own(WINDOW *win, int begy, int nlines)
+{
+    int y;
+
+    if (win->_cow->pages)
+    {
+        win->_cow->pages->pinned = TRUE;
+
+        for (y = begy; y < begy + nlines; y++)
+            PDC_page_write(win, y);
+
+        return;
+    }
+
+    for (y = begy; win->_cow && y < begy + nlines; y++)
+        if (win->_cow->line[y] && win->_cow->line[y]->owner != win)
+            _unshare(win, y);
+}
+
+/* before win's lines are freed: leave the shared ones to the other
+   holders, and set them to NULL in win */
+
+void PDC_cow_release(WINDOW *win)
+{
+    PDC_COWLINE *line;
+    int y;
+
+    if (win->_cow->pages)
+    {
+        PDC_page_free(win);
+        return;
+    }
+
+    for (y = 0; win->_cow && y < win->_maxy; y++)
+    {
+        line = win->_cow->line[y];
+        if (!line)
+            continue;
+
+        if (line->refs > 1)
+        {
+            if (line->owner == win)
+                line->owner = NULL;
+            else
+                line->dups--;
+
+            line->refs--;
+            win->_y[y] = NULL;
+        }
+        else
+            free(line);
+
+        _forget(win, y);
+    }
+}
+
+/* the shared line for line y of win, and the offset of win's cells in
+   it; lines that can't be shared are copied */
+
+static PDC_COWLINE *_snap_line(WINDOW *win, int y, int *offset)
+{
+    WINDOW *w = win;
+    PDC_COWLINE *line = NULL;
+    size_t size;
+    int ry = y;
+
+    while (w->_parent && ry >= 0)
+    {
+        ry = _parent_line(w, ry);
+        w = w->_parent;
+    }
+
+    if (ry >= 0 && !(w->_flags & (_SUBWIN|_SUBPAD)) &&
+        !(w->_cow && w->_cow->pages))
+        line = _share(w, ry);
+
+    if (line)
+    {
+        line->refs++;
+        *offset = (int)(win->_y[y] - w->_y[ry]);
+
+        return line;
+    }
+
+    size = win->_maxx * sizeof(chtype);
+
+    line = malloc(sizeof(PDC_COWLINE));
+    if (!line)
+        return NULL;
+
+    line->cells = PDC_pool_alloc(size);
+    if (!line->cells)
+    {
+        free(line);
+        return NULL;
+    }
+
+    PDC_STAT(allocs, 1);
+
+    memcpy(line->cells, win->_y[y], size);
+
+    line->refs = 1;
+    line->dups = 0;
+    line->owner = NULL;
+    *offset = 0;
+
+    return line;
+}
+
+PDC_SNAPSHOT *PDC_snapshot(WINDOW *win)
+{
+    PDC_SNAPSHOT *snap;
+    int y;
+
+    PDC_LOG(("PDC_snapshot() - called: win=%p\n", win));
+
+    if (!win)
+        return NULL;
+
+    snap = malloc(sizeof(PDC_SNAPSHOT));
+    if (!snap)
+        return NULL;
+
+    snap->line = malloc(win->_maxy * sizeof(PDC_COWLINE *));
+    snap->offset = malloc(win->_maxy * sizeof(int));
+
+    if (!snap->line || !snap->offset)
+    {
+        free(snap->line);
+        free(snap->offset);
+        free(snap);
+        return NULL;
+    }
+
+    PDC_STAT(allocs, 3);
+
+    PDC_LAZY_FLUSH(win);
+
+    for (y = 0; y < win->_maxy; y++)
+    {
+        snap->line[y] = _snap_line(win, y, snap->offset + y);
+
+        if (!snap->line[y])
+        {
+            snap->nlines = y;
+            PDC_free_snapshot(snap);
+            return NULL;
+        }
+    }
+
+    snap->nlines = win->_maxy;
+    snap->ncols = win->_maxx;
+    snap->cury = win->_cury;
+    snap->curx = win->_curx;
+    snap->attrs = win->_attrs;
+    snap->bkgd = win->_bkgd;
+
+    return snap;
+}
+
+int PDC_restore_snapshot(WINDOW *win, const PDC_SNAPSHOT *snap)
+{
+    const chtype *src;
+    chtype *dest;
+    int y, first, last, ncols;
+
+    PDC_LOG(("PDC_restore_snapshot() - called: win=%p\n", win));
+
+    if (!win || !snap || win->_maxy != snap->nlines ||
+        win->_maxx != snap->ncols)
+        return ERR;
+
+    ncols = snap->ncols;
+
+    for (y = 0; y < snap->nlines; y++)
+    {
+        PDC_LAZY_WRITE(win, y, 0, ncols - 1);
+
+        /* a line still shared with the snapshot is unchanged */
+
+        src = snap->line[y]->cells + snap->offset[y];
+        dest = win->_y[y];
+
+        if (src == dest)
+            continue;
+
+        for (first = 0; first < ncols && src[first] == dest[first]; first++)
+            ;
+
+        if (first == ncols)
+            continue;
+
+        for (last = ncols - 1; src[last] == dest[last]; last--)
+            ;
+
+        PDC_COW_WRITE(win, y);
+
+        src = snap->line[y]->cells + snap->offset[y];
+        dest = win->_y[y];
+
+        memmove(dest + first, src + first,
+                (last - first + 1) * sizeof(chtype));
+
+        if (first < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
+            win->_firstch[y] = first;
+
+        if (last > win->_lastch[y])
+            win->_lastch[y] = last;
+    }
+
+    win->_cury = snap->cury;
+    win->_curx = snap->curx;
+    win->_attrs = snap->attrs;
+    win->_bkgd = snap->bkgd;
+
+    PDC_sync(win);
+
+    return OK;
+}
+
+void PDC_free_snapshot(PDC_SNAPSHOT *snap)
+{
+    int y;
+
+    PDC_LOG(("PDC_free_snapshot() - called\n"));
+
+    if (!snap)
+        return;
+
+    for (y = 0; y < snap->nlines; y++)
+        _drop(snap->line[y]);
+
+    free(snap->line);
+    free(snap->offset);
+    free(snap);
+}
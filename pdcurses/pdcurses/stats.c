@@ -0,0 +1,77 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+stats
+-----
+
+### Synopsis
+
+    int PDC_get_stats(PDC_STATS *stats);
+    void PDC_reset_stats(void);
+
+### Description
+
+   PDCurses keeps running counts of the work done at the main choke
+   points of screen output and input: the cells copied into curscr by
+   wnoutrefresh() and pnoutrefresh(); the calls to doupdate(), the cells
+   it compares with the screen, and the runs of changed cells (and the
+   cells in them) that it passes to the platform layer; and the memory
+   allocations made by the library. The SDL ports also count the
+   same-attribute packets that the runs are split into, the glyphs and
+   backgrounds blitted, the update rectangles presented, the glyphs
+   rendered by SDL_ttf (in the wide-character build), and the input
+   events polled. See PDC_STATS in curses.h for the field names.
+
+   The counts are cheap enough to keep all the time, so they can show
+   why a frame was expensive, in production code, without attaching a
+   profiler: take a copy before and after the frame, and compare them.
+
+   PDC_get_stats() copies the current counts to the structure pointed
+   to by stats. PDC_reset_stats() sets them all to zero.
+
+   If the library is built with PDC_NO_STATS defined, the counters are
+   compiled out.
+
+### Return Value
+
+   PDC_get_stats() returns OK, or ERR if stats is NULL, or the counters
+   were compiled out (in which case the structure is zeroed).
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_get_stats         |    -   |    -    |   -
+   PDC_reset_stats       |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <string.h>
+
+PDC_STATS pdc_stats;
+
+int PDC_get_stats(PDC_STATS *stats)
+{
+    PDC_LOG(("PDC_get_stats() - called\n"));
+
+    if (!stats)
+        return ERR;
+
+    *stats = pdc_stats;
+
+#ifdef PDC_NO_STATS
+    return ERR;
+#else
+    return OK;
+#endif
+}
+
+void PDC_reset_stats(void)
+{
+    PDC_LOG(("PDC_reset_stats() - called\n"));
+
+    memset(&pdc_stats, 0, sizeof(PDC_STATS));
+}
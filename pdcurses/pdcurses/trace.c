@@ -0,0 +1,474 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+trace
+-----
+
+### Synopsis
+
+    unsigned long PDC_trace_filter(unsigned long categories);
+    int PDC_trace_dump(const char *filename);
+
+### Description
+
+   When PDCurses is built with PDC_TRACE defined (and PDCDEBUG not
+   defined), the PDC_LOG() calls throughout the library feed a "flight
+   recorder" instead of the text trace file. Each call that passes the
+   filter stores a small fixed-size record -- the call site, a timestamp
+   in microseconds, and up to four of its arguments -- in a ring buffer
+   in memory, holding the most recent PDC_TRACE_RECORDS (16384) calls.
+   Nothing is formatted or written until the buffer is dumped, so the
+   tracing is cheap enough to leave on.
+
+   PDC_trace_filter() sets the categories of calls to record, and
+   returns the previous setting. The categories, which may be OR'd
+   together, are PDC_TRACE_OUTPUT (writing to windows), PDC_TRACE_REFRESH
+   (refreshes, pads and panels), PDC_TRACE_INPUT, PDC_TRACE_WINDOW
+   (creating, moving and configuring windows, and the screen),
+   PDC_TRACE_COLOR (colors and attributes), PDC_TRACE_PLATFORM (the
+   platform layer) and PDC_TRACE_MISC; or PDC_TRACE_ALL. A filter of 0
+   stops recording.
+
+   PDC_trace_dump() writes the contents of the ring buffer, oldest first,
+   to the named file, in a compact binary form that's independent of the
+   host's byte order; use the pdctrace tool (in the bench directory) to
+   decode it. The buffer is not cleared. Without PDC_TRACE, these
+   functions are still present, but nothing is recorded.
+
+   If the environment variable PDC_TRACE_DUMP names a file when
+   initscr() is called, recording starts, and the buffer is dumped to
+   that file when the program exits. PDC_TRACE_FILTER may be set to a
+   comma-separated list of category names ("output", "refresh",
+   "input", "window", "color", "platform", "misc" or "all") to record;
+   by default, all are.
+
+### Return Value
+
+   PDC_trace_dump() returns OK on success, or ERR if the file could not
+   be written.
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_trace_filter      |    -   |    -    |   -
+   PDC_trace_dump        |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Reading the clock would cost more than the rest of a record, so on
+   x86 with GCC or Clang, the time stamp counter is read instead, and
+   converted to microseconds when the buffer is dumped, by comparing
+   its progress with the clock's since tracing started. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <x86intrin.h>
+typedef unsigned long long TICKS;
+# define _ticks() __rdtsc()
+#else
+typedef double TICKS;
+# define _ticks() _now()
+#endif
+
+/* The call sites are identified by the address of their format string.
+   The first time one is seen, it's entered in a hash table, with its
+   category (from the name of its source file) and the types of its
+   first four arguments (from the format); each record then refers to
+   it by its index in the table. A string argument is stored as its
+   first sizeof(size_t) bytes.
+
+   The dump starts with the signature "PDCtrc", a NUL and a version
+   byte, then the number of call sites and, for each, the category, the
+   source file and the format, then the number of records and the
+   records, oldest first. Each record is the timestamp, the call site,
+   the number of arguments and the arguments. Numbers are written as
+   unsigned LEB128, as in input logs (see replay.c), and strings as a
+   length followed by the bytes. */
+
+#define _TRC_VERSION 1
+
+#define _TRC_MAXARGS 4
+#define _TRC_MAXSITES 2048     /* size of the hash table; a power of 2 */
+
+enum { _ARG_INT, _ARG_LONG, _ARG_PTR, _ARG_STR };
+
+static const char trc_sig[8] = {'P', 'D', 'C', 't', 'r', 'c', 0,
+                                _TRC_VERSION};
+
+typedef struct
+{
+    TICKS when;
+    unsigned short site;        /* index into sites */
+    unsigned short nargs;
+    size_t args[_TRC_MAXARGS];
+} TRACEREC;
+
+typedef struct
+{
+    const char *fmt;
+    const char *file;
+    unsigned long category;
+    int nargs;
+    unsigned char kinds[_TRC_MAXARGS];
+} TRACESITE;
+
+unsigned long pdc_trace_mask = 0;
+const char *pdc_trace_file = NULL;
+
+static TRACEREC ring[PDC_TRACE_RECORDS];
+static unsigned long ring_next = 0;     /* total records written */
+
+static TRACESITE sites[_TRC_MAXSITES];
+static unsigned short site_index[_TRC_MAXSITES];  /* hash -> site + 1 */
+static int nsites = 0;
+
+static double trace_start = 0;     /* clock, in microseconds */
+static TICKS ticks_start;           /* and ticks, when tracing started */
+
+static const struct
+{
+    const char *name;
+    unsigned long category;
+} categories[] =
+{
+    {"output", PDC_TRACE_OUTPUT}, {"refresh", PDC_TRACE_REFRESH},
+    {"input", PDC_TRACE_INPUT}, {"window", PDC_TRACE_WINDOW},
+    {"color", PDC_TRACE_COLOR}, {"platform", PDC_TRACE_PLATFORM},
+    {"misc", PDC_TRACE_MISC}, {"all", PDC_TRACE_ALL}, {NULL, 0}
+};
+
+/* the category of each source file; platform files are recognized by
+   their "pdc" prefix */
+
+static const struct
+{
+    const char *file;
+    unsigned long category;
+} file_categories[] =
+{
+    {"addch.c", PDC_TRACE_OUTPUT}, {"addchstr.c", PDC_TRACE_OUTPUT},
+    {"addstr.c", PDC_TRACE_OUTPUT}, {"bkgd.c", PDC_TRACE_OUTPUT},
+    {"border.c", PDC_TRACE_OUTPUT}, {"clear.c", PDC_TRACE_OUTPUT},
+    {"delch.c", PDC_TRACE_OUTPUT}, {"deleteln.c", PDC_TRACE_OUTPUT},
+    {"insch.c", PDC_TRACE_OUTPUT}, {"insstr.c", PDC_TRACE_OUTPUT},
+    {"overlay.c", PDC_TRACE_OUTPUT}, {"printw.c", PDC_TRACE_OUTPUT},
+    {"scroll.c", PDC_TRACE_OUTPUT},
+
+    {"pad.c", PDC_TRACE_REFRESH}, {"panel.c", PDC_TRACE_REFRESH},
+    {"refresh.c", PDC_TRACE_REFRESH}, {"touch.c", PDC_TRACE_REFRESH},
+
+    {"getch.c", PDC_TRACE_INPUT}, {"getstr.c", PDC_TRACE_INPUT},
+    {"inch.c", PDC_TRACE_INPUT}, {"inchstr.c", PDC_TRACE_INPUT},
+    {"inopts.c", PDC_TRACE_INPUT}, {"instr.c", PDC_TRACE_INPUT},
+    {"keyname.c", PDC_TRACE_INPUT}, {"mouse.c", PDC_TRACE_INPUT},
+    {"replay.c", PDC_TRACE_INPUT}, {"scanw.c", PDC_TRACE_INPUT},
+
+    {"getyx.c", PDC_TRACE_WINDOW}, {"initscr.c", PDC_TRACE_WINDOW},
+    {"kernel.c", PDC_TRACE_WINDOW}, {"move.c", PDC_TRACE_WINDOW},
+    {"outopts.c", PDC_TRACE_WINDOW}, {"scr_dump.c", PDC_TRACE_WINDOW},
+    {"pool.c", PDC_TRACE_WINDOW}, {"provider.c", PDC_TRACE_WINDOW},
+    {"slk.c", PDC_TRACE_WINDOW}, {"snapshot.c", PDC_TRACE_WINDOW},
+    {"window.c", PDC_TRACE_WINDOW},
+
+    {"attr.c", PDC_TRACE_COLOR}, {"color.c", PDC_TRACE_COLOR},
+    {"termattr.c", PDC_TRACE_COLOR},
+
+    {NULL, 0}
+};
+
+static double _now(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+#else
+    return clock() * (1e6 / CLOCKS_PER_SEC);
+#endif
+}
+
+static unsigned long _file_category(const char *file)
+{
+    const char *base = file;
+    int i;
+
+    for (; *file; file++)
+        if (*file == '/' || *file == '\\' || *file == ':')
+            base = file + 1;
+
+    if (!strncmp(base, "pdc", 3))
+        return PDC_TRACE_PLATFORM;
+
+    for (i = 0; file_categories[i].file; i++)
+        if (!strcmp(base, file_categories[i].file))
+            return file_categories[i].category;
+
+    return PDC_TRACE_MISC;
+}
+
+/* parse a format for the types of its first arguments */
+
+static void _parse_format(TRACESITE *site)
+{
+    const char *p = site->fmt;
+
+    site->nargs = 0;
+
+    while (*p && site->nargs < _TRC_MAXARGS)
+    {
+        bool islong = FALSE;
+
+        if (*p++ != '%')
+            continue;
+
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+
+        while (*p && strchr("-+ #0123456789.", *p))
+            p++;
+
+        while (*p == 'l' || *p == 'h')
+            islong |= (*p++ == 'l');
+
+        switch (*p)
+        {
+        case 's':
+            site->kinds[site->nargs++] = _ARG_STR;
+            break;
+        case 'p':
+            site->kinds[site->nargs++] = _ARG_PTR;
+            break;
+        case '\0':
+            return;
+        default:
+            site->kinds[site->nargs++] = islong ? _ARG_LONG : _ARG_INT;
+        }
+
+        p++;
+    }
+}
+
+static TRACESITE *_find_site(const char *fmt, unsigned short *index)
+{
+    unsigned long h = ((unsigned long)(size_t)fmt >> 3) &
+                      (_TRC_MAXSITES - 1);
+    TRACESITE *site;
+
+    while (site_index[h])
+    {
+        site = sites + site_index[h] - 1;
+        if (site->fmt == fmt)
+        {
+            *index = site_index[h] - 1;
+            return site;
+        }
+
+        h = (h + 1) & (_TRC_MAXSITES - 1);
+    }
+
+    /* not seen before -- keep the table no more than half full */
+
+    if (nsites >= _TRC_MAXSITES / 2)
+        return NULL;
+
+    site = sites + nsites;
+    site->fmt = fmt;
+    site->file = pdc_trace_file ? pdc_trace_file : "";
+    site->category = _file_category(site->file);
+    _parse_format(site);
+
+    *index = nsites;
+    site_index[h] = ++nsites;
+
+    return site;
+}
+
+void PDC_trace(const char *fmt, ...)
+{
+    va_list args;
+    TRACESITE *site;
+    TRACEREC *rec;
+    unsigned short index;
+    int i;
+
+    site = _find_site(fmt, &index);
+    if (!site || !(site->category & pdc_trace_mask))
+        return;
+
+    rec = ring + (ring_next++ & (PDC_TRACE_RECORDS - 1));
+
+    rec->when = _ticks();
+    rec->site = index;
+    rec->nargs = site->nargs;
+
+    va_start(args, fmt);
+
+    for (i = 0; i < site->nargs; i++)
+    {
+        switch (site->kinds[i])
+        {
+        case _ARG_INT:
+            rec->args[i] = (size_t)va_arg(args, unsigned int);
+            break;
+        case _ARG_LONG:
+            rec->args[i] = (size_t)va_arg(args, unsigned long);
+            break;
+        case _ARG_PTR:
+            rec->args[i] = (size_t)va_arg(args, void *);
+            break;
+        case _ARG_STR:
+        {
+            const char *str = va_arg(args, const char *);
+
+            rec->args[i] = 0;
+            if (str)
+                strncpy((char *)(rec->args + i), str, sizeof(size_t));
+        }
+            break;
+        }
+    }
+
+    va_end(args);
+}
+
+unsigned long PDC_trace_filter(unsigned long categories)
+{
+    unsigned long old = pdc_trace_mask;
+
+    if (categories && !trace_start)
+    {
+        trace_start = _now();
+        ticks_start = _ticks();
+    }
+
+    pdc_trace_mask = categories;
+
+    return old;
+}
+
+static void _put_num(FILE *fp, unsigned long num)
+{
+    while (num > 0x7f)
+    {
+        putc((int)(num & 0x7f) | 0x80, fp);
+        num >>= 7;
+    }
+
+    putc((int)num, fp);
+}
+
+static void _put_str(FILE *fp, const char *str, size_t len)
+{
+    _put_num(fp, (unsigned long)len);
+    fwrite(str, len, 1, fp);
+}
+
+int PDC_trace_dump(const char *filename)
+{
+    FILE *fp;
+    unsigned long first, n;
+    double per_us = 1;
+    int i, j;
+
+    if (trace_start && _now() > trace_start)
+        per_us = (double)(_ticks() - ticks_start) / (_now() - trace_start);
+
+    fp = fopen(filename, "wb");
+    if (!fp)
+        return ERR;
+
+    fwrite(trc_sig, sizeof(trc_sig), 1, fp);
+
+    _put_num(fp, nsites);
+
+    for (i = 0; i < nsites; i++)
+    {
+        _put_num(fp, sites[i].category);
+        _put_str(fp, sites[i].file, strlen(sites[i].file));
+        _put_str(fp, sites[i].fmt, strlen(sites[i].fmt));
+    }
+
+    first = (ring_next > PDC_TRACE_RECORDS) ?
+            ring_next - PDC_TRACE_RECORDS : 0;
+
+    _put_num(fp, ring_next - first);
+
+    for (n = first; n < ring_next; n++)
+    {
+        TRACEREC *rec = ring + (n & (PDC_TRACE_RECORDS - 1));
+
+        _put_num(fp, (unsigned long)((rec->when - ticks_start) / per_us));
+        _put_num(fp, rec->site);
+        _put_num(fp, rec->nargs);
+
+        for (j = 0; j < rec->nargs; j++)
+        {
+            if (sites[rec->site].kinds[j] == _ARG_STR)
+            {
+                const char *str = (const char *)(rec->args + j);
+                size_t len = 0;
+
+                while (len < sizeof(size_t) && str[len])
+                    len++;
+
+                _put_str(fp, str, len);
+            }
+            else
+                _put_num(fp, (unsigned long)rec->args[j]);
+        }
+    }
+
+    return fclose(fp) ? ERR : OK;
+}
+
+static const char *dump_file = NULL;
+
+static void _dump_at_exit(void)
+{
+    PDC_trace_dump(dump_file);
+}
+
+void PDC_trace_init(void)
+{
+    const char *env;
+    unsigned long mask = PDC_TRACE_ALL;
+
+    if (dump_file || (dump_file = getenv("PDC_TRACE_DUMP")) == NULL)
+        return;
+
+    env = getenv("PDC_TRACE_FILTER");
+    if (env)
+    {
+        mask = 0;
+
+        while (*env)
+        {
+            size_t len = strcspn(env, ",");
+            int i;
+
+            for (i = 0; categories[i].name; i++)
+                if (strlen(categories[i].name) == len &&
+                    !strncmp(env, categories[i].name, len))
+                    mask |= categories[i].category;
+
+            env += len;
+            if (*env)
+                env++;
+        }
+    }
+
+    PDC_trace_filter(mask);
+    atexit(_dump_at_exit);
+}
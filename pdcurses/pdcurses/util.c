@@ -190,12 +190,31 @@ wchar_t *wunctrl(cchar_t *wc)
     return strbuf;
 }
 
+# ifdef PDC_FORCE_UTF8
+
+/* UTF-8 sequence length by the top five bits of the lead byte; 0 for
+   continuation bytes and the unused 0xf8-0xff */
+
+static const unsigned char utf8_len[32] =
+{
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0
+};
+
+static const unsigned char utf8_mask[5] = {0, 0x7f, 0x1f, 0x0f, 0x07};
+
+/* the smallest code point for each length, to reject overlong forms */
+
+static const unsigned long utf8_min[5] = {0, 0, 0x80, 0x800, 0x10000};
+
+# endif
+
 int PDC_mbtowc(wchar_t *pwc, const char *s, size_t n)
 {
 # ifdef PDC_FORCE_UTF8
-    wchar_t key;
-    int i = -1;
     const unsigned char *string;
+    unsigned long key;
+    int i, len;
 
     if (!s || (n < 1))
         return -1;
@@ -204,43 +223,66 @@ int PDC_mbtowc(wchar_t *pwc, const char *s, size_t n)
         return 0;
 
     string = (const unsigned char *)s;
+    len = utf8_len[string[0] >> 3];
 
-    key = string[0];
+    if (!len || (size_t)len > n)
+        return -1;
 
-    /* Simplistic UTF-8 decoder -- only does the BMP, minimal validation */
+    key = string[0] & utf8_mask[len];
 
-    if (key & 0x80)
+    for (i = 1; i < len; i++)
     {
-        if ((key & 0xe0) == 0xc0)
-        {
-            if (1 < n)
-            {
-                key = ((key & 0x1f) << 6) | (string[1] & 0x3f);
-                i = 2;
-            }
-        }
-        else if ((key & 0xe0) == 0xe0)
-        {
-            if (2 < n)
-            {
-                key = ((key & 0x0f) << 12) | ((string[1] & 0x3f) << 6) |
-                      (string[2] & 0x3f);
-                i = 3;
-            }
-        }
+        if ((string[i] & 0xc0) != 0x80)
+            return -1;
+
+        key = (key << 6) | (string[i] & 0x3f);
     }
-    else
-        i = 1;
 
-    if (i)
-        *pwc = key;
+    if (key < utf8_min[len] || key > 0x10ffff ||
+        (key >= 0xd800 && key <= 0xdfff))
+        return -1;
 
-    return i;
+    /* characters outside the BMP need a wchar_t wider than UTF-16 */
+
+    if (key > 0xffff && sizeof(wchar_t) < 4)
+        key = 0xfffd;
+
+    if (pwc)
+        *pwc = (wchar_t)key;
+
+    return len;
 # else
     return mbtowc(pwc, s, n);
 # endif
 }
 
+/* whether the n bytes at s begin a valid character that runs past them,
+   as when a string is cut short by a byte count */
+
+bool PDC_mbpartial(const char *s, size_t n)
+{
+# ifdef PDC_FORCE_UTF8
+    const unsigned char *string = (const unsigned char *)s;
+    size_t i, len;
+
+    if (!s || (n < 1))
+        return FALSE;
+
+    len = utf8_len[string[0] >> 3];
+
+    if (len <= n)
+        return FALSE;
+
+    for (i = 1; i < n; i++)
+        if ((string[i] & 0xc0) != 0x80)
+            return FALSE;
+
+    return TRUE;
+# else
+    return FALSE;
+# endif
+}
+
 size_t PDC_mbstowcs(wchar_t *dest, const char *src, size_t n)
 {
 # ifdef PDC_FORCE_UTF8
@@ -293,13 +335,21 @@ size_t PDC_wcstombs(char *dest, const wchar_t *src, size_t n)
                 dest[i + 1] = (code & 0x003f) | 0x80;
                 i += 2;
             }
-            else
+            else if (code < 0x10000)
             {
                 dest[i] = ((code & 0xf000) >> 12) | 0xe0;
                 dest[i + 1] = ((code & 0x0fc0) >> 6) | 0x80;
                 dest[i + 2] = (code & 0x003f) | 0x80;
                 i += 3;
             }
+            else
+            {
+                dest[i] = ((code & 0x1c0000) >> 18) | 0xf0;
+                dest[i + 1] = ((code & 0x03f000) >> 12) | 0x80;
+                dest[i + 2] = ((code & 0x0fc0) >> 6) | 0x80;
+                dest[i + 3] = (code & 0x003f) | 0x80;
+                i += 4;
+            }
     }
 # else
     size_t i = wcstombs(dest, src, n);
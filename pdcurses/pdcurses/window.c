@@ -31,6 +31,8 @@ window
     WINDOW *PDC_makelines(WINDOW *win);
     WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx);
     void PDC_sync(WINDOW *win);
+    int PDC_begin_batch(void);
+    int PDC_end_batch(void);
 
 ### Description
 
@@ -65,7 +67,9 @@ window
    This routine is used to display different parts of the parent window
    at the same physical position on the screen.
 
-   dupwin() creates an exact duplicate of the window win.
+   dupwin() creates an exact duplicate of the window win. Unless win is
+   a subwindow, the two share their lines until either one writes to
+   them, so this is cheap even for a large window (see snapshot).
 
    wgetparent() returns the parent WINDOW pointer for subwindows, or NULL
    for windows having no parent.
@@ -88,7 +92,11 @@ window
    parent's windows have been touched.
 
    resize_window() allows the user to resize an existing window. It
-   returns the pointer to the new window, or NULL on failure.
+   returns the pointer to the new window, or NULL on failure. Unless the
+   window is a subwindow, or shares its lines (see dupwin() and
+   PDC_newpad_paged()), it's resized in place: lines are reallocated
+   only when they grow past the memory they have, and only the added
+   cells are set to the background.
 
    wresize() is an ncurses-compatible wrapper for resize_window(). Note
    that, unlike ncurses, it will NOT process any subwindows of the
@@ -105,12 +113,22 @@ window
    PDC_sync() handles wrefresh() and wsyncup() calls when a window is
    changed.
 
+   PDC_begin_batch() puts off the work PDC_sync() does -- the refreshes
+   of windows set with immedok(), and the wsyncup() calls for those set
+   with syncok() -- until the matching PDC_end_batch(). Then it's done
+   once for each window changed, with a single doupdate() for all the
+   refreshes, however many times they were changed; so drawing a whole
+   widget into an immedok() window costs one refresh, not one per
+   character. Batches can be nested; the work is done at the end of the
+   outermost one.
+
 ### Return Value
 
    newwin(), subwin(), derwin() and dupwin() return a pointer to the new
    window, or NULL on failure. delwin(), mvwin(), mvderwin() and
-   syncok() return OK or ERR. wsyncup(), wcursyncup() and wsyncdown()
-   return nothing.
+   syncok() return OK or ERR. PDC_begin_batch() returns OK;
+   PDC_end_batch() returns OK, or ERR if no batch was begun. wsyncup(),
+   wcursyncup() and wsyncdown() return nothing.
 
    is_subwin() and is_syncok() returns TRUE or FALSE.
 
@@ -146,10 +164,20 @@ window
    PDC_makelines         |    -   |    -    |   -
    PDC_makenew           |    -   |    -    |   -
    PDC_sync              |    -   |    -    |   -
+   PDC_begin_batch       |    -   |    -    |   -
+   PDC_end_batch         |    -   |    -    |   -
 
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+
+/* windows changed during a batch, whose PDC_sync() is put off till the
+   end of it */
+
+static WINDOW **batch = NULL;
+static int nbatch = 0, maxbatch = 0;
+static int batch_depth = 0;
 
 WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
 {
@@ -160,35 +188,23 @@ WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
 
     /* allocate the window structure itself */
 
-    win = calloc(1, sizeof(WINDOW));
+    win = PDC_pool_alloc(sizeof(WINDOW));
     if (!win)
         return win;
 
-    /* allocate the line pointer array */
+    memset(win, 0, sizeof(WINDOW));
 
-    win->_y = malloc(nlines * sizeof(chtype *));
-    if (!win->_y)
-    {
-        free(win);
-        return (WINDOW *)NULL;
-    }
-
-    /* allocate the minchng and maxchng arrays */
+    /* allocate the line pointer array, and the minchng and maxchng
+       arrays */
 
-    win->_firstch = malloc(nlines * sizeof(int));
-    if (!win->_firstch)
-    {
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    win->_y = PDC_pool_alloc(nlines * sizeof(chtype *));
+    win->_firstch = PDC_pool_alloc(nlines * sizeof(int));
+    win->_lastch = PDC_pool_alloc(nlines * sizeof(int));
 
-    win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
+    if (!win->_y || !win->_firstch || !win->_lastch ||
+        !PDC_arena_add(win))
     {
-        free(win->_firstch);
-        free(win->_y);
-        free(win);
+        PDC_freewin(win);
         return (WINDOW *)NULL;
     }
 
@@ -233,18 +249,15 @@ WINDOW *PDC_makelines(WINDOW *win)
 
     for (i = 0; i < nlines; i++)
     {
-        win->_y[i] = malloc(ncols * sizeof(chtype));
+        win->_y[i] = PDC_pool_alloc(ncols * sizeof(chtype));
         if (!win->_y[i])
         {
             /* if error, free all the data */
 
             for (j = 0; j < i; j++)
-                free(win->_y[j]);
+                PDC_pool_free(win->_y[j]);
 
-            free(win->_firstch);
-            free(win->_lastch);
-            free(win->_y);
-            free(win);
+            PDC_freewin(win);
 
             return (WINDOW *)NULL;
         }
@@ -253,16 +266,138 @@ WINDOW *PDC_makelines(WINDOW *win)
     return win;
 }
 
+/* free a window's structure and arrays, but not its lines, and take it
+   out of any arena scope */
+
+void PDC_freewin(WINDOW *win)
+{
+    int i;
+
+    PDC_arena_forget(win);
+
+    for (i = 0; i < nbatch; i++)
+        if (batch[i] == win)
+            batch[i] = NULL;
+
+    PDC_pool_free(win->_firstch);
+    PDC_pool_free(win->_lastch);
+    PDC_pool_free(win->_y);
+    PDC_pool_free(win);
+}
+
+/* add win to the windows to be synced at the end of the batch, unless
+   it's there already; the last one added is the likeliest */
+
+static void _batch_add(WINDOW *win)
+{
+    WINDOW **tmp;
+    int i;
+
+    for (i = nbatch - 1; i >= 0; i--)
+        if (batch[i] == win)
+            return;
+
+    if (nbatch == maxbatch)
+    {
+        tmp = PDC_pool_alloc((maxbatch ? maxbatch * 2 : 16) *
+                             sizeof(WINDOW *));
+
+        /* if there's no memory to put it off, do it now */
+
+        if (!tmp)
+        {
+            if (win->_immed)
+                wrefresh(win);
+            if (win->_sync)
+                wsyncup(win);
+            return;
+        }
+
+        if (nbatch)
+            memcpy(tmp, batch, nbatch * sizeof(WINDOW *));
+
+        PDC_pool_free(batch);
+        batch = tmp;
+        maxbatch = maxbatch ? maxbatch * 2 : 16;
+    }
+
+    batch[nbatch++] = win;
+}
+
 void PDC_sync(WINDOW *win)
 {
     PDC_LOG(("PDC_sync() - called:\n"));
 
+    if (batch_depth)
+    {
+        if (win->_immed || win->_sync)
+            _batch_add(win);
+
+        return;
+    }
+
     if (win->_immed)
         wrefresh(win);
     if (win->_sync)
         wsyncup(win);
 }
 
+int PDC_begin_batch(void)
+{
+    PDC_LOG(("PDC_begin_batch() - called\n"));
+
+    batch_depth++;
+
+    return OK;
+}
+
+int PDC_end_batch(void)
+{
+    WINDOW *win;
+    bool update = FALSE;
+    int i;
+
+    PDC_LOG(("PDC_end_batch() - called\n"));
+
+    if (!batch_depth)
+        return ERR;
+
+    if (--batch_depth)
+        return OK;
+
+    /* refresh the immedok() windows as wrefresh() does, but with one
+       doupdate() for them all */
+
+    for (i = 0; i < nbatch; i++)
+    {
+        win = batch[i];
+        if (!win)
+            continue;
+
+        if (win->_sync)
+            wsyncup(win);
+
+        if (win->_immed && SP && !(win->_flags & (_PAD|_SUBPAD)))
+        {
+            if (win == curscr || (win->_clear && win->_maxy == SP->lines
+                                  && win->_maxx == SP->cols))
+                curscr->_clear = TRUE;
+
+            if (win != curscr)
+                wnoutrefresh(win);
+
+            update = TRUE;
+        }
+    }
+
+    nbatch = 0;
+
+    if (update)
+        doupdate();
+
+    return OK;
+}
+
 WINDOW *newwin(int nlines, int ncols, int begy, int begx)
 {
     WINDOW *win;
@@ -297,17 +432,24 @@ int delwin(WINDOW *win)
     if (!win)
         return ERR;
 
+    PDC_lazy_erase(win, FALSE);
+
+    /* lines still shared are left to the other holders, and so are
+       NULL here */
+
+    if (win->_cow)
+        PDC_cow_release(win);
+
+    if (win->_provider)
+        PDC_provider_free(win);
+
     /* subwindows use parents' lines */
 
     if (!(win->_flags & (_SUBWIN|_SUBPAD)))
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (win->_y[i])
-                free(win->_y[i]);
+        for (i = 0; i < win->_maxy; i++)
+            PDC_pool_free(win->_y[i]);
 
-    free(win->_firstch);
-    free(win->_lastch);
-    free(win->_y);
-    free(win);
+    PDC_freewin(win);
 
     return OK;
 }
@@ -335,9 +477,10 @@ WINDOW *subwin(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     PDC_LOG(("subwin() - called: lines %d cols %d begy %d begx %d\n",
              nlines, ncols, begy, begx));
 
-    /* make sure window fits inside the original one */
+    /* make sure window fits inside the original one, and doesn't get
+       its lines from a provider */
 
-    if (!orig || (begy < orig->_begy) || (begx < orig->_begx) ||
+    if (!orig || orig->_provider || (begy < orig->_begy) || (begx < orig->_begx) ||
         (begy + nlines) > (orig->_begy + orig->_maxy) ||
         (begx + ncols) > (orig->_begx + orig->_maxx))
         return (WINDOW *)NULL;
@@ -350,6 +493,13 @@ WINDOW *subwin(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     if (!ncols)
         ncols  = orig->_maxx - k;
 
+    /* a window made by dupwin() must stop sharing the lines that will
+       move when it writes to them, and a paged pad must give them
+       storage of their own */
+
+    if (orig->_cow)
+        PDC_cow_own(orig, j, nlines);
+
     win = PDC_makenew(nlines, ncols, begy, begx);
     if (!win)
         return (WINDOW *)NULL;
@@ -410,7 +560,6 @@ int mvderwin(WINDOW *win, int pary, int parx)
 WINDOW *dupwin(WINDOW *win)
 {
     WINDOW *new;
-    chtype *ptr, *ptr1;
     int nlines, ncols, begy, begx, i;
 
     if (!win)
@@ -422,20 +571,26 @@ WINDOW *dupwin(WINDOW *win)
     begx = win->_begx;
 
     new = PDC_makenew(nlines, ncols, begy, begx);
-    if (new)
-        new = PDC_makelines(new);
-
     if (!new)
         return (WINDOW *)NULL;
 
-    /* copy the contents of win into new */
+    PDC_LAZY_FLUSH(win);
 
-    for (i = 0; i < nlines; i++)
+    /* share the lines of win with new, copy-on-write, or if win is a
+       subwindow, copy them */
+
+    if (PDC_cow_dup(win, new) == ERR)
     {
-        for (ptr = new->_y[i], ptr1 = win->_y[i];
-             ptr < new->_y[i] + ncols; ptr++, ptr1++)
-            *ptr = *ptr1;
+        new = PDC_makelines(new);
+        if (!new)
+            return (WINDOW *)NULL;
+
+        for (i = 0; i < nlines; i++)
+            memcpy(new->_y[i], win->_y[i], ncols * sizeof(chtype));
+    }
 
+    for (i = 0; i < nlines; i++)
+    {
         new->_firstch[i] = 0;
         new->_lastch[i] = ncols - 1;
     }
@@ -475,10 +630,113 @@ WINDOW *wgetparent(const WINDOW *win)
     return win->_parent;
 }
 
+/* resize a window with lines of its own, none of them shared, keeping
+   its lines where they are. Memory is needed only where a line, or the
+   arrays of lines, must grow beyond the size of their pool blocks; as
+   the block sizes go up in steps of a third or a half, a window that
+   grows a column at a time is moved only every so often. Lines dropped
+   go back to the pool, as do lines that are moved. If there's no
+   memory, the window is left as it was, but with some lines perhaps
+   moved already. */
+
+static bool _resize_in_place(WINDOW *win, int nlines, int ncols)
+{
+    chtype **y = win->_y;
+    int *firstch = win->_firstch, *lastch = win->_lastch;
+    int i, j, keep = min(nlines, win->_maxy);
+    size_t size = ncols * sizeof(chtype);
+    chtype *line;
+
+    /* lines growing beyond their blocks move to bigger ones */
+
+    if (ncols > win->_maxx)
+        for (i = 0; i < keep; i++)
+            if (size > PDC_pool_size(win->_y[i]))
+            {
+                line = PDC_pool_alloc(size);
+                if (!line)
+                    return FALSE;
+
+                memcpy(line, win->_y[i], win->_maxx * sizeof(chtype));
+                PDC_pool_free(win->_y[i]);
+                win->_y[i] = line;
+            }
+
+    /* as do the arrays */
+
+    if (nlines > win->_maxy &&
+        (nlines * sizeof(chtype *) > PDC_pool_size(y) ||
+         nlines * sizeof(int) > PDC_pool_size(firstch) ||
+         nlines * sizeof(int) > PDC_pool_size(lastch)))
+    {
+        y = PDC_pool_alloc(nlines * sizeof(chtype *));
+        firstch = PDC_pool_alloc(nlines * sizeof(int));
+        lastch = PDC_pool_alloc(nlines * sizeof(int));
+
+        if (!y || !firstch || !lastch)
+        {
+            PDC_pool_free(y);
+            PDC_pool_free(firstch);
+            PDC_pool_free(lastch);
+            return FALSE;
+        }
+
+        memcpy(y, win->_y, keep * sizeof(chtype *));
+    }
+
+    /* new lines */
+
+    for (i = keep; i < nlines; i++)
+    {
+        y[i] = PDC_pool_alloc(size);
+        if (!y[i])
+        {
+            for (j = keep; j < i; j++)
+                PDC_pool_free(y[j]);
+
+            if (y != win->_y)
+            {
+                PDC_pool_free(y);
+                PDC_pool_free(firstch);
+                PDC_pool_free(lastch);
+            }
+
+            return FALSE;
+        }
+
+        PDC_fill(y[i], win->_bkgd, ncols);
+    }
+
+    /* nothing can fail now */
+
+    for (i = nlines; i < win->_maxy; i++)
+        PDC_pool_free(win->_y[i]);
+
+    if (y != win->_y)
+    {
+        PDC_pool_free(win->_y);
+        PDC_pool_free(win->_firstch);
+        PDC_pool_free(win->_lastch);
+
+        win->_y = y;
+        win->_firstch = firstch;
+        win->_lastch = lastch;
+    }
+
+    /* blank the columns added to the lines kept */
+
+    if (ncols > win->_maxx)
+        for (i = 0; i < keep; i++)
+            PDC_fill(y[i] + win->_maxx, win->_bkgd, ncols - win->_maxx);
+
+    return TRUE;
+}
+
 WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 {
     WINDOW *new;
     int i, save_cury, save_curx, new_begy, new_begx;
+    bool lazy;
 
     PDC_LOG(("resize_window() - called: nlines %d ncols %d\n",
              nlines, ncols));
@@ -486,6 +744,58 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     if (!win || !SP)
         return (WINDOW *)NULL;
 
+    /* a window with lines of its own, not shared with a copy or in
+       pages, can keep them */
+
+    if (!(win->_flags & (_SUBPAD|_SUBWIN)) && !win->_cow)
+    {
+        if (nlines < 1 || ncols < 1)
+            return (WINDOW *)NULL;
+
+        /* the lazy erase state is sized for the old window */
+
+        lazy = !!win->_lazy;
+        PDC_lazy_erase(win, FALSE);
+
+        if (!_resize_in_place(win, nlines, ncols))
+        {
+            if (lazy)
+                PDC_lazy_erase(win, TRUE);
+
+            return (WINDOW *)NULL;
+        }
+
+        if (win == SP->slk_winptr)
+        {
+            win->_begy = SP->lines - SP->slklines;
+            win->_begx = 0;
+        }
+
+        win->_tmarg = (win->_tmarg > nlines - 1) ? 0 : win->_tmarg;
+        win->_bmarg = (win->_bmarg == win->_maxy - 1) ?
+                      nlines - 1 : min(win->_bmarg, (nlines - 1));
+        win->_maxy = nlines;
+        win->_maxx = ncols;
+        win->_curx = min(win->_curx, (ncols - 1));
+        win->_cury = min(win->_cury, (nlines - 1));
+
+        /* a pad is shown afresh */
+
+        win->_pad._pad_y = -1;
+        win->_pad._pad_x = -1;
+        win->_pad._pad_top = -1;
+        win->_pad._pad_left = -1;
+        win->_pad._pad_bottom = -1;
+        win->_pad._pad_right = -1;
+
+        touchwin(win);
+
+        if (lazy)
+            PDC_lazy_erase(win, TRUE);
+
+        return win;
+    }
+
     if (win->_flags & _SUBPAD)
     {
         new = subpad(win->_parent, nlines, ncols, win->_begy, win->_begx);
@@ -521,19 +831,25 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 
     if (!(win->_flags & (_SUBPAD|_SUBWIN)))
     {
-        new = PDC_makelines(new);
+        /* a paged pad stays paged; its blank line takes the
+           background */
+
+        new->_bkgd = win->_bkgd;
+        new = (win->_cow && win->_cow->pages) ? PDC_makepages(new) :
+                                                PDC_makelines(new);
         if (!new)
             return (WINDOW *)NULL;
 
-        new->_bkgd = win->_bkgd;
         werase(new);
 
         copywin(win, new, 0, 0, 0, 0, min(win->_maxy, new->_maxy) - 1,
                 min(win->_maxx, new->_maxx) - 1, FALSE);
 
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (win->_y[i])
-                free(win->_y[i]);
+        if (win->_cow)
+            PDC_cow_release(win);
+
+        for (i = 0; i < win->_maxy; i++)
+            PDC_pool_free(win->_y[i]);
     }
 
     new->_flags = win->_flags;
@@ -548,6 +864,7 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     new->_bmarg = (win->_bmarg == win->_maxy - 1) ?
                   new->_maxy - 1 : min(win->_bmarg, (new->_maxy - 1));
     new->_parent = win->_parent;
+    new->_provider = win->_provider;
     new->_immed = win->_immed;
     new->_sync = win->_sync;
     new->_bkgd = win->_bkgd;
@@ -555,12 +872,22 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     new->_curx = save_curx;
     new->_cury = save_cury;
 
-    free(win->_firstch);
-    free(win->_lastch);
-    free(win->_y);
+    /* the lazy erase state is sized for the old window */
+
+    lazy = !!win->_lazy;
+    PDC_lazy_erase(win, FALSE);
+
+    PDC_pool_free(win->_firstch);
+    PDC_pool_free(win->_lastch);
+    PDC_pool_free(win->_y);
 
     *win = *new;
-    free(new);
+
+    PDC_arena_forget(new);
+    PDC_pool_free(new);
+
+    if (lazy)
+        PDC_lazy_erase(win, TRUE);
 
     return win;
 }
@@ -31,14 +31,33 @@ void PDC_update_rects(void)
            probably better off doing a full screen update */
 
         if (rectcount == MAXRECT)
+        {
             SDL_Flip(pdc_screen);
+            PDC_STAT(rects, 1);
+        }
         else
+        {
             SDL_UpdateRects(pdc_screen, rectcount, uprect);
+            PDC_STAT(rects, rectcount);
+        }
 
         rectcount = 0;
     }
 }
 
+/* a color has been changed by init_color(); if it's one of those set
+   in the font's palette, it must be set again */
+
+void PDC_color_changed(short color)
+{
+    if (color == foregr)
+        foregr = -2;
+    if (color == backgr)
+        backgr = -2;
+
+    oldch = (chtype)(-1);
+}
+
 /* set the font colors to match the chtype's attribute */
 
 static void _set_attr(chtype ch)
@@ -267,6 +286,7 @@ void PDC_gotoyx(int row, int col)
 
         chstr[0] = ch & A_CHARTEXT;
 
+        PDC_STAT(renders, 1);
         pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
                                              pdc_color[foregr]);
         if (pdc_font)
@@ -276,6 +296,7 @@ void PDC_gotoyx(int row, int col)
             src.x = 0;
             src.y = pdc_fheight - src.h;
             dest.x += center;
+            PDC_STAT(blits, 1);
             SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
             dest.x -= center;
             SDL_FreeSurface(pdc_font);
@@ -289,6 +310,7 @@ void PDC_gotoyx(int row, int col)
     src.x = (ch & 0xff) % 32 * pdc_fwidth;
     src.y = (ch & 0xff) / 32 * pdc_fheight + (pdc_fheight - src.h);
 
+    PDC_STAT(blits, 1);
     SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
 #endif
 
@@ -312,6 +334,8 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     short hcol = SP->line_color;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
+    PDC_STAT(packets, 1);
+
     if (rectcount == MAXRECT)
         PDC_update_rects();
 
@@ -348,7 +372,10 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     _set_attr(attr);
 
     if (backgr == -1)
+    {
         SDL_LowerBlit(pdc_tileback, &dest, pdc_screen, &dest);
+        PDC_STAT(blits, 1);
+    }
 #ifdef PDC_WIDE
     else
         SDL_FillRect(pdc_screen, &dest, pdc_mapped[backgr]);
@@ -390,6 +417,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                 if (pdc_font)
                     SDL_FreeSurface(pdc_font);
 
+                PDC_STAT(renders, 1);
                 pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
                                                      pdc_color[foregr]);
             }
@@ -399,6 +427,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                 int center = pdc_fwidth > pdc_font->w ?
                     (pdc_fwidth - pdc_font->w) >> 1 : 0;
                 dest.x += center;
+                PDC_STAT(blits, 1);
                 SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
                 dest.x -= center;
             }
@@ -407,6 +436,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         src.x = (ch & 0xff) % 32 * pdc_fwidth;
         src.y = (ch & 0xff) / 32 * pdc_fheight;
 
+        PDC_STAT(blits, 1);
         SDL_LowerBlit(pdc_font, &src, pdc_screen, &dest);
 #endif
 
@@ -526,4 +556,9 @@ void PDC_blink_text(void)
 void PDC_doupdate(void)
 {
     PDC_napms(1);
+
+    /* init_pair() may change the colors of an attribute before the next
+       update */
+
+    oldch = (chtype)(-1);
 }
@@ -83,6 +83,9 @@ bool PDC_check_key(void)
 {
     int haveevent = SDL_PollEvent(&event);
 
+    if (haveevent)
+        PDC_STAT(events, 1);
+
     return haveevent;
 }
 
@@ -32,3 +32,4 @@ PDCEX  void PDC_update_rects(void);
 PDCEX  void PDC_retile(void);
 
 extern void PDC_blink_text(void);
+extern void PDC_color_changed(short);
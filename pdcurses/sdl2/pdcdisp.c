@@ -33,7 +33,10 @@ void PDC_update_rects(void)
            probably better off doing a full screen update */
 
         if (rectcount == MAXRECT)
+        {
             SDL_UpdateWindowSurface(pdc_window);
+            PDC_STAT(rects, 1);
+        }
         else
         {
             int w = pdc_screen->w;
@@ -63,13 +66,29 @@ void PDC_update_rects(void)
             }
 
             if (rectcount > 0)
+            {
                 SDL_UpdateWindowSurfaceRects(pdc_window, uprect, rectcount);
+                PDC_STAT(rects, rectcount);
+            }
         }
 
         rectcount = 0;
     }
 }
 
+/* a color has been changed by init_color(); if it's one of those set
+   in the font's palette, it must be set again */
+
+void PDC_color_changed(short color)
+{
+    if (color == foregr)
+        foregr = -2;
+    if (color == backgr)
+        backgr = -2;
+
+    oldch = (chtype)(-1);
+}
+
 /* set the font colors to match the chtype's attribute */
 
 static void _set_attr(chtype ch)
@@ -298,6 +317,7 @@ void PDC_gotoyx(int row, int col)
 
         chstr[0] = ch & A_CHARTEXT;
 
+        PDC_STAT(renders, 1);
         pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
                                              pdc_color[foregr]);
         if (pdc_font)
@@ -307,6 +327,7 @@ void PDC_gotoyx(int row, int col)
             src.x = 0;
             src.y = pdc_fheight - src.h;
             dest.x += center;
+            PDC_STAT(blits, 1);
             SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
             dest.x -= center;
             SDL_FreeSurface(pdc_font);
@@ -320,6 +341,7 @@ void PDC_gotoyx(int row, int col)
     src.x = (ch & 0xff) % 32 * pdc_fwidth;
     src.y = (ch & 0xff) / 32 * pdc_fheight + (pdc_fheight - src.h);
 
+    PDC_STAT(blits, 1);
     SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
 #endif
 
@@ -343,6 +365,8 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     short hcol = SP->line_color;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
+    PDC_STAT(packets, 1);
+
     if (rectcount == MAXRECT)
         PDC_update_rects();
 
@@ -379,7 +403,10 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     _set_attr(attr);
 
     if (backgr == -1)
+    {
         SDL_BlitSurface(pdc_tileback, &dest, pdc_screen, &dest);
+        PDC_STAT(blits, 1);
+    }
 #ifdef PDC_WIDE
     else
         SDL_FillRect(pdc_screen, &dest, pdc_mapped[backgr]);
@@ -421,6 +448,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                 if (pdc_font)
                     SDL_FreeSurface(pdc_font);
 
+                PDC_STAT(renders, 1);
                 pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
                                                      pdc_color[foregr]);
             }
@@ -430,6 +458,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                 int center = pdc_fwidth > pdc_font->w ?
                     (pdc_fwidth - pdc_font->w) >> 1 : 0;
                 dest.x += center;
+                PDC_STAT(blits, 1);
                 SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
                 dest.x -= center;
             }
@@ -438,6 +467,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         src.x = (ch & 0xff) % 32 * pdc_fwidth;
         src.y = (ch & 0xff) / 32 * pdc_fheight;
 
+        PDC_STAT(blits, 1);
         SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
 #endif
 
@@ -536,6 +566,9 @@ void PDC_blink_text(void)
 
     blinked_off = !blinked_off;
 
+    if (SP->suspended)
+        return;
+
     for (i = 0; i < SP->lines; i++)
     {
         const chtype *srcp = curscr->_y[i];
@@ -559,23 +592,50 @@ void PDC_blink_text(void)
 void PDC_doupdate(void)
 {
     PDC_update_rects();
+
+    /* init_pair() may change the colors of an attribute before the next
+       update */
+
+    oldch = (chtype)(-1);
 }
 
-void PDC_pump_and_peep(void)
+/* keep track of whether the window can be seen. While it's hidden or
+   minimized (or, in a browser, in a background tab), nothing is drawn;
+   when it's shown again, everything that changed meanwhile is drawn at
+   once. Returns TRUE if the event was one of these. */
+
+bool PDC_window_shown(const SDL_Event *event)
 {
-    SDL_Event event;
+    if (SDL_WINDOWEVENT != event->type)
+        return FALSE;
 
-    if (SDL_PollEvent(&event))
+    switch (event->window.event)
     {
-        if (SDL_WINDOWEVENT == event.type &&
-            (SDL_WINDOWEVENT_RESTORED == event.window.event ||
-             SDL_WINDOWEVENT_EXPOSED == event.window.event ||
-             SDL_WINDOWEVENT_SHOWN == event.window.event))
+    case SDL_WINDOWEVENT_HIDDEN:
+    case SDL_WINDOWEVENT_MINIMIZED:
+        SP->suspended = TRUE;
+        return TRUE;
+    case SDL_WINDOWEVENT_RESTORED:
+    case SDL_WINDOWEVENT_EXPOSED:
+    case SDL_WINDOWEVENT_SHOWN:
+        if (SP->suspended)
         {
-            SDL_UpdateWindowSurface(pdc_window);
-            rectcount = 0;
+            SP->suspended = FALSE;
+            doupdate();
         }
-        else
-            SDL_PushEvent(&event);
+
+        SDL_UpdateWindowSurface(pdc_window);
+        rectcount = 0;
+        return TRUE;
     }
+
+    return FALSE;
+}
+
+void PDC_pump_and_peep(void)
+{
+    SDL_Event event;
+
+    if (SDL_PollEvent(&event) && !PDC_window_shown(&event))
+        SDL_PushEvent(&event);
 }
@@ -9,6 +9,17 @@ static SDL_Event event;
 static SDL_Keycode oldkey;
 static MOUSE_STATUS old_mouse_status;
 
+/* A change in the size of the window is acted on only once it has
+   stopped changing for PDC_RESIZE_DELAY milliseconds, so that dragging
+   its edge doesn't redraw it at every step. */
+
+#ifndef PDC_RESIZE_DELAY
+# define PDC_RESIZE_DELAY 100
+#endif
+
+static bool resize_pending = FALSE;
+static Uint32 resize_time;
+
 static struct
 {
     SDL_Keycode keycode;
@@ -91,7 +102,24 @@ bool PDC_check_key(void)
     if (event.type == SDL_TEXTINPUT && event.text.text[0])
         haveevent = 1;
     else
+    {
         haveevent = SDL_PollEvent(&event);
+        if (haveevent)
+            PDC_STAT(events, 1);
+        else if (resize_pending &&
+                 SDL_TICKS_PASSED(SDL_GetTicks(),
+                                  resize_time + PDC_RESIZE_DELAY))
+        {
+            /* the window has stopped changing size; SDL never sends
+               SDL_WINDOWEVENT_NONE, so it marks this for PDC_get_key() */
+
+            resize_pending = FALSE;
+
+            event.type = SDL_WINDOWEVENT;
+            event.window.event = SDL_WINDOWEVENT_NONE;
+            haveevent = 1;
+        }
+    }
 
     return haveevent;
 }
@@ -405,6 +433,58 @@ static int _process_mouse_event(void)
     return KEY_MOUSE;
 }
 
+/* get the window's surface again, after its size has changed. What was
+   on the old one is copied to the new one, and only the cells that were
+   beyond the edges of the old one are drawn again -- none, unless the
+   window is bigger than it was. Returns TRUE if the number of rows or
+   columns that fit in it has changed. */
+
+static bool _resize(void)
+{
+    SDL_Surface *old;
+    int i, row, col;
+
+    old = SDL_ConvertSurface(pdc_screen, pdc_screen->format, 0);
+
+    pdc_screen = SDL_GetWindowSurface(pdc_window);
+    pdc_sheight = pdc_screen->h - pdc_yoffset;
+    pdc_swidth = pdc_screen->w - pdc_xoffset;
+
+    if (old && !pdc_tileback)
+    {
+        SDL_BlitSurface(old, NULL, pdc_screen, NULL);
+
+        row = (old->h - pdc_yoffset) / pdc_fheight;
+        col = (old->w - pdc_xoffset) / pdc_fwidth;
+    }
+    else
+    {
+        if (pdc_tileback)
+            PDC_retile();
+
+        row = col = 0;
+    }
+
+    SDL_FreeSurface(old);
+
+    if (row < 0)
+        row = 0;
+    if (col < 0)
+        col = 0;
+
+    for (i = 0; i < SP->lines; i++)
+    {
+        if (i >= row)
+            PDC_transform_line(i, 0, SP->cols, curscr->_y[i]);
+        else if (col < SP->cols)
+            PDC_transform_line(i, col, SP->cols - col, curscr->_y[i] + col);
+    }
+
+    PDC_doupdate();
+
+    return PDC_get_rows() != SP->lines || PDC_get_columns() != SP->cols;
+}
+
 /* return the next available key or mouse event */
 
 int PDC_get_key(void)
@@ -414,15 +494,17 @@ int PDC_get_key(void)
     case SDL_QUIT:
         exit(1);
     case SDL_WINDOWEVENT:
+        if (PDC_window_shown(&event))
+            break;
+
         if (SDL_WINDOWEVENT_SIZE_CHANGED == event.window.event)
         {
-            pdc_screen = SDL_GetWindowSurface(pdc_window);
-            pdc_sheight = pdc_screen->h - pdc_xoffset;
-            pdc_swidth = pdc_screen->w - pdc_yoffset;
-            touchwin(curscr);
-            wrefresh(curscr);
-
-            if (!SP->resized)
+            resize_pending = TRUE;
+            resize_time = SDL_GetTicks();
+        }
+        else if (SDL_WINDOWEVENT_NONE == event.window.event)
+        {
+            if (_resize() && !SP->resized)
             {
                 SP->resized = TRUE;
                 SP->key_code = TRUE;
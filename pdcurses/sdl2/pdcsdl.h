@@ -34,3 +34,5 @@ PDCEX  void PDC_retile(void);
 
 extern void PDC_pump_and_peep(void);
 extern void PDC_blink_text(void);
+extern bool PDC_window_shown(const SDL_Event *);
+extern void PDC_color_changed(short);